@@ -81,6 +81,8 @@
 #define OCT 2
 #define HEX 3
 
+#define SERIAL_DEFAULT_BAUD_RATE 921600
+
 #ifndef false
 #define false 0
 #endif
@@ -100,12 +102,25 @@
 #define ADC_INT_INDEX   5
 #define CODEC_INT_INDEX 6
 
+//============================================================================================
+// Number printers, one core file each. print() / println() pick the printer
+// from the format, so with a constant format only that printer is linked.
+//============================================================================================
+typedef uint8_t* (*NUM_TO_ASCII) (int32_t num);
+
+extern uint8_t* num_to_dec (int32_t num);
+extern uint8_t* num_to_hex (int32_t num);
+extern uint8_t* num_to_oct (int32_t num);
+extern uint8_t* num_to_bin (int32_t num);
+
+#define NUM_TO_ASCII_OF(fmt) (((fmt) == BIN) ? num_to_bin : ((fmt) == OCT) ? num_to_oct : ((fmt) == HEX) ? num_to_hex : num_to_dec)
+#define PRINT_ARGS(num, fmt) ((num), NUM_TO_ASCII_OF(fmt))
+
 typedef struct {
    void (*begin) (uint32_t); 
    uint8_t (*available)();
-   void (*_print) (int32_t num, uint8_t fmt) __reentrant;
-   void (*printHex) (uint32_t num);
-   void (*_println) (int32_t data, uint8_t fmt) __reentrant;
+   void (*_print) (int32_t num, NUM_TO_ASCII printer) __reentrant;
+   void (*_println) (int32_t data, NUM_TO_ASCII printer) __reentrant;
    void (*writeByte) (uint8_t data);
    
    uint8_t   (*read)();
@@ -113,13 +128,14 @@ typedef struct {
    
    void (*_write) (uint8_t* buf, uint16_t length) __reentrant;
    void (*setTimeout)(uint32_t time_out_in_ms);
-   uint8_t readLn(uint8_t* buf, uint16_t max_length) __reentrant;
+   uint8_t (*readLn) (uint8_t* buf, uint16_t max_length) __reentrant;
    void (*end)();   
    
 } SERIAL_STRUCT;
 
-#define print(...) IF_ELSE(PP_NARG(__VA_ARGS__))(_print( __VA_ARGS__ , DEC ))(_print( __VA_ARGS__ )) 
-#define println(...) IF_ELSE(PP_NARG(__VA_ARGS__))(_println( __VA_ARGS__ , DEC ))(_println( __VA_ARGS__ )) 
+#define print(...) IF_ELSE(PP_NARG(__VA_ARGS__))(_print( __VA_ARGS__ , num_to_dec ))(_print PRINT_ARGS( __VA_ARGS__ )) 
+#define println(...) IF_ELSE(PP_NARG(__VA_ARGS__))(_println( __VA_ARGS__ , num_to_dec ))(_println PRINT_ARGS( __VA_ARGS__ )) 
+#define printHex(num) _print ((num), num_to_hex)
 
 #define write(...) IF_ELSE(PP_NARG(__VA_ARGS__))(_write( __VA_ARGS__ , 0 ))(_write( __VA_ARGS__ )) 
 
@@ -163,4 +179,19 @@ extern void noInterrupts();
 
 extern void attachIsrHandler(uint8_t index,  void (*isr_handler_pointer)());
 
+typedef void (*ISR_HANDLER_POINTER)();
+
+extern void (*codec_isr_handler_pointer)();
+extern __data ISR_HANDLER_POINTER codec_fast_isr_pointer;
+
+#include "audio.h"
+#include "dsp.h"
+#include "jtag.h"
+#include "chip_id.h"
+#include "profile.h"
+#include "stack.h"
+#include "boot.h"
+#include "telemetry.h"
+#include "serial_line.h"
+
 #endif
@@ -0,0 +1,50 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// digital_to_ascii()
+//
+// Parameters:
+//      num    :  a byte to convert to ascii 
+//
+// Return Value:
+//      converted ascii code
+//
+// Remarks:
+//      function to convert a byte number to its ascii code for display
+//----------------------------------------------------------------------------
+uint8_t digital_to_ascii (uint8_t num)
+{
+    if (num < 10) {
+        return (num + '0');
+    } else {
+        return (num - 10 + 'A');
+    }
+} // End of digital_to_ascii()
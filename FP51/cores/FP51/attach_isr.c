@@ -0,0 +1,84 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// attachIsrHandler()
+//
+// Parameters:
+//      index                     : IRQ index
+//      codec_isr_handler_pointer : isr function pointer
+// 
+// Return Value:
+//      None
+//
+// Remarks:
+//      setup isr handler
+//----------------------------------------------------------------------------
+void attachIsrHandler(uint8_t index,  void (*isr_handler_pointer)())
+{
+    if (index == ADC_INT_INDEX) {
+        adc_isr_handler_pointer = isr_handler_pointer;
+        
+        if (isr_handler_pointer) {
+            EADC = 1;
+        } else {
+            EADC = 0;
+        }
+        
+    } else if (index == CODEC_INT_INDEX) {
+        codec_isr_handler_pointer = isr_handler_pointer;
+        if (isr_handler_pointer) {
+            ECODEC = 1;
+        } else {
+            ECODEC = 0;
+        }
+    } else if (index == INT1_I2C_INT_INDEX) {
+        int1_i2c_isr_handler_pointer = isr_handler_pointer;
+        if (isr_handler_pointer) {
+            EX1 = 1;
+        } else {
+            EX1 = 0;
+        }
+    } else if (index == INT0_INT_INDEX) {
+        int0_isr_handler_pointer = isr_handler_pointer;
+        if (isr_handler_pointer) {
+            EX0 = 1;
+        } else {
+            EX0 = 0;
+        }
+    } else if (index == TIMER0_INT_INDEX) {
+        timer0_isr_handler_pointer = isr_handler_pointer;
+        if (isr_handler_pointer) {
+            ET0 = 1;
+        } else {
+            ET0 = 0;
+        }       
+    }
+} // End of attachISR()
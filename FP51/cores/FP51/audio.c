@@ -0,0 +1,332 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "audio.h"
+
+//----------------------------------------------------------------------------
+// sample buffers, two halves (frames) each
+//----------------------------------------------------------------------------
+
+__xdata int16_t audio_playback_buffer [2][AUDIO_FRAME_SIZE];
+__xdata int16_t audio_capture_buffer [2][AUDIO_FRAME_SIZE];
+
+//----------------------------------------------------------------------------
+// ISR state, kept in __data so the ISR can reach it with direct addressing
+//----------------------------------------------------------------------------
+
+__data uint16_t audio_playback_ptr;
+__data uint16_t audio_capture_ptr;
+__data uint8_t  audio_sample_count;
+__data uint8_t  audio_frame_samples;
+__data uint8_t  audio_half;
+
+__data uint16_t audio_underrun_count;
+__data uint16_t audio_overrun_count;
+
+__bit audio_frame_ready;
+__bit audio_playback_enabled;
+__bit audio_capture_enabled;
+
+static AUDIO_FRAME_CALLBACK audio_playback_callback;
+static AUDIO_FRAME_CALLBACK audio_capture_callback;
+
+
+//----------------------------------------------------------------------------
+// audio_stream_isr()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      per-sample CODEC handler. It is jumped to from __codec_isr() with
+//      ACC, DPL and DPH already pushed, and it only uses those registers.
+//      Of the PSW flags, only P changes (it follows A), and it follows A
+//      back when ACC is popped. The PSW does not need to be saved.
+//----------------------------------------------------------------------------
+
+void audio_stream_isr (void) __naked
+{
+     //== play one sample
+     __asm__ ("mov dpl, _audio_playback_ptr");
+     __asm__ ("mov dph, (_audio_playback_ptr + 1)");
+     __asm__ ("movx a, @dptr");
+     __asm__ ("mov _CODEC_WRITE_DATA_LOW, a");
+     __asm__ ("inc dptr");
+     __asm__ ("movx a, @dptr");
+     __asm__ ("mov _CODEC_WRITE_DATA_HIGH, a");
+     __asm__ ("inc dptr");
+     __asm__ ("mov _audio_playback_ptr, dpl");
+     __asm__ ("mov (_audio_playback_ptr + 1), dph");
+
+     //== capture one sample
+     __asm__ ("mov dpl, _audio_capture_ptr");
+     __asm__ ("mov dph, (_audio_capture_ptr + 1)");
+     __asm__ ("mov a, _CODEC_READ_DATA_LOW");
+     __asm__ ("movx @dptr, a");
+     __asm__ ("inc dptr");
+     __asm__ ("mov a, _CODEC_READ_DATA_HIGH");
+     __asm__ ("movx @dptr, a");
+     __asm__ ("inc dptr");
+     __asm__ ("mov _audio_capture_ptr, dpl");
+     __asm__ ("mov (_audio_capture_ptr + 1), dph");
+
+     __asm__ ("djnz _audio_sample_count, 00004$");
+
+     //== end of frame, move on to the other half
+     __asm__ ("mov _audio_sample_count, _audio_frame_samples");
+     __asm__ ("xrl _audio_half, #1");
+     __asm__ ("mov a, _audio_half");
+     __asm__ ("jnz 00001$");
+
+     __asm__ ("mov _audio_playback_ptr, #_audio_playback_buffer");
+     __asm__ ("mov (_audio_playback_ptr + 1), #(_audio_playback_buffer >> 8)");
+     __asm__ ("mov _audio_capture_ptr, #_audio_capture_buffer");
+     __asm__ ("mov (_audio_capture_ptr + 1), #(_audio_capture_buffer >> 8)");
+
+     __asm__ ("00001$:");
+
+     //== the previous frame has not been serviced yet
+     __asm__ ("jnb _audio_frame_ready, 00003$");
+
+     __asm__ ("jnb _audio_playback_enabled, 00002$");
+     __asm__ ("inc _audio_underrun_count");
+     __asm__ ("mov a, _audio_underrun_count");
+     __asm__ ("jnz 00002$");
+     __asm__ ("inc (_audio_underrun_count + 1)");
+
+     __asm__ ("00002$:");
+     __asm__ ("jnb _audio_capture_enabled, 00003$");
+     __asm__ ("inc _audio_overrun_count");
+     __asm__ ("mov a, _audio_overrun_count");
+     __asm__ ("jnz 00003$");
+     __asm__ ("inc (_audio_overrun_count + 1)");
+
+     __asm__ ("00003$:");
+     __asm__ ("setb _audio_frame_ready");
+
+     __asm__ ("00004$:");
+     __asm__ ("pop dph");
+     __asm__ ("pop dpl");
+     __asm__ ("pop acc");
+
+     __asm__ ("reti");
+
+} // End of audio_stream_isr()
+
+
+//----------------------------------------------------------------------------
+// audio_stream_begin()
+//
+// Parameters:
+//      playback_callback : called with the frame to be filled for playback,
+//                          NULL if playback is not used
+//      capture_callback  : called with the frame that has just been
+//                          captured, NULL if capture is not used
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to clear the sample buffers and start the streaming
+//----------------------------------------------------------------------------
+
+void audio_stream_begin (AUDIO_FRAME_CALLBACK playback_callback, AUDIO_FRAME_CALLBACK capture_callback)
+{
+    uint8_t i;
+
+    ECODEC = 0;
+
+    for (i = 0; i < AUDIO_FRAME_SIZE; ++i) {
+        audio_playback_buffer[0][i] = 0;
+        audio_playback_buffer[1][i] = 0;
+    } // End of for loop
+
+    audio_playback_callback = playback_callback;
+    audio_capture_callback  = capture_callback;
+
+    audio_playback_enabled = (playback_callback != 0);
+    audio_capture_enabled  = (capture_callback != 0);
+
+    audio_playback_ptr  = (uint16_t)(&audio_playback_buffer[0][0]);
+    audio_capture_ptr   = (uint16_t)(&audio_capture_buffer[0][0]);
+    audio_frame_samples = AUDIO_FRAME_SIZE;
+    audio_sample_count  = AUDIO_FRAME_SIZE;
+    audio_half          = 0;
+
+    audio_underrun_count = 0;
+    audio_overrun_count  = 0;
+    audio_frame_ready    = 0;
+
+    codec_fast_isr_pointer = audio_stream_isr;
+
+    ECODEC = 1;
+
+} // End of audio_stream_begin()
+
+
+//----------------------------------------------------------------------------
+// audio_stream_end()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to stop the streaming and hand the CODEC interrupt back
+//      to the handler set by attachIsrHandler(), if there is one
+//----------------------------------------------------------------------------
+
+void audio_stream_end ()
+{
+    ECODEC = 0;
+
+    codec_fast_isr_pointer = 0;
+
+    if (codec_isr_handler_pointer) {
+        ECODEC = 1;
+    }
+
+} // End of audio_stream_end()
+
+
+//----------------------------------------------------------------------------
+// audio_stream_service()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      1 if a frame has been processed
+//      0 if no frame is ready
+//
+// Remarks:
+//      function to be called from loop(). When the ISR has finished a
+//      frame, the capture callback is handed the samples just received,
+//      and the playback callback refills the frame just played. Both
+//      callbacks must return before the ISR finishes the next frame,
+//      otherwise the underrun / overrun counters go up. The flag is
+//      cleared before the callbacks, so a frame finished while they run
+//      is handed out by the next call, not lost.
+//----------------------------------------------------------------------------
+
+uint8_t audio_stream_service ()
+{
+    uint8_t half;
+    uint8_t ea;
+
+    if (!audio_frame_ready) {
+        return 0;
+    }
+
+    ea = EA;
+    EA = 0;
+    half = audio_half ^ 1;
+    audio_frame_ready = 0;
+    EA = ea;
+
+    if (audio_capture_callback) {
+        audio_capture_callback (&audio_capture_buffer[half][0]);
+    }
+
+    if (audio_playback_callback) {
+        audio_playback_callback (&audio_playback_buffer[half][0]);
+    }
+
+    //== the callbacks ran past the end of the next frame
+    ea = EA;
+    EA = 0;
+
+    if (audio_frame_ready) {
+        if (audio_playback_enabled) {
+            ++audio_underrun_count;
+        }
+
+        if (audio_capture_enabled) {
+            ++audio_overrun_count;
+        }
+    }
+
+    EA = ea;
+
+    return 1;
+
+} // End of audio_stream_service()
+
+
+//----------------------------------------------------------------------------
+// audio_stream_underruns()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of frames played without being refilled
+//
+// Remarks:
+//      function to read the playback underrun counter
+//----------------------------------------------------------------------------
+
+uint16_t audio_stream_underruns ()
+{
+    uint16_t temp;
+
+    EA = 0;
+    temp = audio_underrun_count;
+    EA = 1;
+
+    return temp;
+} // End of audio_stream_underruns()
+
+
+//----------------------------------------------------------------------------
+// audio_stream_overruns()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of captured frames lost before being serviced
+//
+// Remarks:
+//      function to read the capture overrun counter
+//----------------------------------------------------------------------------
+
+uint16_t audio_stream_overruns ()
+{
+    uint16_t temp;
+
+    EA = 0;
+    temp = audio_overrun_count;
+    EA = 1;
+
+    return temp;
+} // End of audio_stream_overruns()
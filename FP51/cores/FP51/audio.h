@@ -0,0 +1,55 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Double-buffered (ping-pong) audio streaming over the CODEC interrupt
+//
+// The CODEC ISR moves exactly one sample per interrupt: it plays the next
+// sample from the playback buffer and stores the received sample into the
+// capture buffer. Each buffer is split into two halves of AUDIO_FRAME_SIZE
+// samples. When the ISR finishes one half it moves on to the other one, and
+// flags the finished half for audio_stream_service(), which runs the frame
+// callbacks in the main loop.
+//
+// The CODEC itself (sampling rate, gain etc.) has to be configured before
+// audio_stream_begin() is called.
+//============================================================================================
+
+#ifndef AUDIO_FRAME_SIZE
+#define AUDIO_FRAME_SIZE 32
+#endif
+
+C_ASSERT((AUDIO_FRAME_SIZE > 0) && (AUDIO_FRAME_SIZE < 256));
+
+typedef void (*AUDIO_FRAME_CALLBACK) (int16_t* frame);
+
+extern void audio_stream_begin (AUDIO_FRAME_CALLBACK playback_callback, AUDIO_FRAME_CALLBACK capture_callback);
+extern void audio_stream_end ();
+extern uint8_t audio_stream_service ();
+
+extern uint16_t audio_stream_underruns ();
+extern uint16_t audio_stream_overruns ();
+
+#endif
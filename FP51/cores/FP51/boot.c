@@ -0,0 +1,199 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "boot.h"
+
+#ifdef NOINIT
+
+#define BOOT_NOINIT_MAGIC 0xB007
+
+static __xdata __at (NOINIT_ADDRESS)     volatile uint16_t boot_noinit_magic;
+static __xdata __at (NOINIT_ADDRESS + 2) volatile uint16_t boot_noinit_count;
+
+#endif
+
+static __data uint32_t boot_cycle_count;
+static __data uint8_t  boot_cold_flag;
+
+//----------------------------------------------------------------------------
+// boot_timer_read()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      cycles since BOOT_TIMER_START() or the last boot_timer_read()
+//
+// Remarks:
+//      function to read Timer 0, with the overflow flag as bit 16, and to
+//      restart it from 0
+//----------------------------------------------------------------------------
+
+static uint32_t boot_timer_read ()
+{
+    uint32_t temp;
+
+    TR0 = 0;
+
+    temp = ((uint16_t)TH0 << 8) | TL0;
+
+    if (TF0) {
+        temp += 0x10000;
+    }
+
+    TH0 = 0;
+    TL0 = 0;
+    TF0 = 0;
+    TR0 = 1;
+
+    return temp;
+
+} // End of boot_timer_read()
+
+
+//----------------------------------------------------------------------------
+// boot_mark_main()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to take the time spent in the startup code, and to check
+//      the noinit window (with NOINIT). Called by main() before anything
+//      else.
+//----------------------------------------------------------------------------
+
+void boot_mark_main ()
+{
+    boot_cycle_count = boot_timer_read ();
+
+#ifdef NOINIT
+    if (boot_noinit_magic == BOOT_NOINIT_MAGIC) {
+        boot_cold_flag = 0;
+        ++boot_noinit_count;
+    } else {
+        boot_cold_flag = 1;
+        boot_noinit_magic = BOOT_NOINIT_MAGIC;
+        boot_noinit_count = 0;
+    }
+#else
+    boot_cold_flag = 1;
+#endif
+
+} // End of boot_mark_main()
+
+
+//----------------------------------------------------------------------------
+// boot_mark_setup()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to add the time spent in main() before setup(), and to
+//      stop Timer 0. Called by main() right before setup().
+//----------------------------------------------------------------------------
+
+void boot_mark_setup ()
+{
+    boot_cycle_count += boot_timer_read ();
+
+    TR0 = 0;
+
+} // End of boot_mark_setup()
+
+
+//----------------------------------------------------------------------------
+// boot_cycles()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      CPU cycles from the first instruction to setup()
+//
+// Remarks:
+//      function to read the boot time, divide by BOOT_CYCLES_PER_US for
+//      microseconds
+//----------------------------------------------------------------------------
+
+uint32_t boot_cycles ()
+{
+    return boot_cycle_count;
+
+} // End of boot_cycles()
+
+
+//----------------------------------------------------------------------------
+// boot_cold()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      1 if the noinit window did not hold valid data at boot (power up),
+//      0 if it did (reset). Always 1 without NOINIT.
+//
+// Remarks:
+//      function to tell whether the __noinit variables need to be set up
+//----------------------------------------------------------------------------
+
+uint8_t boot_cold ()
+{
+    return boot_cold_flag;
+
+} // End of boot_cold()
+
+
+//----------------------------------------------------------------------------
+// boot_count()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of resets since the last power up, 0 without NOINIT
+//
+// Remarks:
+//      function to read the reset counter kept in the noinit window
+//----------------------------------------------------------------------------
+
+uint16_t boot_count ()
+{
+#ifdef NOINIT
+    return boot_noinit_count;
+#else
+    return 0;
+#endif
+
+} // End of boot_count()
@@ -0,0 +1,92 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Boot time measurement and noinit data
+//
+// _sdcc_external_startup() in main.c runs before the C runtime clears and
+// initializes __xdata, and starts Timer 0 with BOOT_TIMER_START(). main()
+// calls boot_mark_main() first thing and boot_mark_setup() right before
+// setup(), so boot_cycles() is the time from the first instruction to
+// setup(). Each of the two legs may be up to 2 ** 17 cycles (the timer
+// plus its overflow flag), and Timer 0 is left stopped for the sketch.
+//
+// With NOINIT (Tools > Noinit XRAM), the top NOINIT_SIZE bytes of XRAM
+// are kept out of the link (build.xram_flags in boards.txt), so the
+// startup code does not clear them and they survive a reset. Without it
+// the whole XRAM is left to the linker, and __noinit is not defined.
+// Variables are placed there by offset:
+//
+//      __noinit (0) uint16_t restart_count;
+//      __noinit (2) uint8_t  last_mode;
+//
+// Their content is garbage after power up, which boot_cold() tells. Big
+// buffers that need no clearing can go there as well, to take them out
+// of the area the startup code has to clear.
+//
+// Build with FAST_BOOT (the "Boot" menu) to leave Serial (and Timer 1,
+// which millis() and delay() also run on) alone until its first use, and
+// to skip stack_paint() unless STACK_CHECK is on as well.
+//============================================================================================
+
+#ifdef NOINIT
+
+#ifndef NOINIT_ADDRESS
+#define NOINIT_ADDRESS 0x1F00
+#endif
+
+#ifndef NOINIT_SIZE
+#define NOINIT_SIZE 0x100
+#endif
+
+// magic word and reset counter, at the bottom of the window
+#define NOINIT_CORE_SIZE 4
+
+C_ASSERT(NOINIT_CORE_SIZE < NOINIT_SIZE);
+
+#define __noinit(offset) __xdata __at (NOINIT_ADDRESS + NOINIT_CORE_SIZE + (offset))
+
+#endif
+
+#define BOOT_CYCLES_PER_US 96
+
+// Timer 0 free running (mode 1, 16 bit) from 0, SFR writes only, as it
+// runs before the C runtime is set up
+#define BOOT_TIMER_START() do { \
+    TMOD = 0x01;                \
+    TH0 = 0;                    \
+    TL0 = 0;                    \
+    TF0 = 0;                    \
+    TR0 = 1;                    \
+} while (0)
+
+extern void boot_mark_main ();
+extern void boot_mark_setup ();
+
+extern uint32_t boot_cycles ();
+extern uint8_t boot_cold ();
+extern uint16_t boot_count ();
+
+#endif
@@ -0,0 +1,61 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "chip_id.h"
+
+__data uint8_t chip_id [CHIP_ID_LENGTH];
+__data uint8_t chip_revision;
+
+//----------------------------------------------------------------------------
+// chip_id_begin()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to read the chip ID and the MCU revision into __data.
+//      Writing 0xFF to CHIP_ID_DATA_CSR starts the read out, and the 64 bit
+//      ID then comes out one byte per read, MSB first.
+//----------------------------------------------------------------------------
+
+void chip_id_begin ()
+{
+    uint8_t i;
+
+    CHIP_ID_DATA_CSR = 0xFF;
+
+    for (i = 0; i < CHIP_ID_LENGTH; ++i) {
+        chip_id[i] = CHIP_ID_DATA_CSR;
+    } // End of for loop
+
+    chip_revision = MCU_REVISION;
+
+} // End of chip_id_begin()
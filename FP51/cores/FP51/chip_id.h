@@ -0,0 +1,46 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#ifndef CHIP_ID_H
+#define CHIP_ID_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Chip identity
+//
+// The 64 bit unique ID of the MAX 10 FPGA and the MCU revision are read
+// once by chip_id_begin() (called from main() before setup()), and kept
+// in __data. chip_id[0] is the MSB, the first byte out of
+// CHIP_ID_DATA_CSR.
+//============================================================================================
+
+#define CHIP_ID_LENGTH 8
+
+extern __data uint8_t chip_id [CHIP_ID_LENGTH];
+extern __data uint8_t chip_revision;
+
+#define CHIP_ID_BYTE(index) (chip_id[(index)])
+#define MCU_REVISION_ID()   (chip_revision)
+
+extern void chip_id_begin ();
+
+#endif
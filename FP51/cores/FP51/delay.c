@@ -0,0 +1,69 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// delay()
+//
+// Parameters:
+//      delay_in_ms : delay in millisecond
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to delay by milliseconds
+//----------------------------------------------------------------------------
+
+void delay (uint32_t delay_in_ms)
+{
+    uint8_t small_tick = 0;
+    uint32_t temp;
+    
+    SERIAL_LAZY_BEGIN();
+    
+    // temp = delay_in_ms * 3125 / 6944;
+    
+    temp = delay_in_ms * 375 / serial_rate_factor; // 96e3 / (833 * 256)
+    
+    while(temp) {
+        TF1 = 0;
+        while (!TF1){
+          //  k = TCON;
+          //  serial_print_hex (k);
+          //  serial_putchar ('=');
+          
+        } // End of while loop
+        ++small_tick;
+        if (small_tick == 127) {
+            --temp;
+        }
+    } // End of while loop
+    
+} // delay()
@@ -0,0 +1,56 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// digitalRead()
+//
+// Parameters:
+//      pin    : pin index
+//
+// Return Value:
+//      current value (voltage high / low) on the pin
+//
+// Remarks:
+//      function to read the current value on the pin
+//----------------------------------------------------------------------------
+
+uint8_t digitalRead (uint8_t pin)
+{
+    uint8_t port_index = (pin >> 3);
+    uint8_t mask = 1 << (pin & 7);
+    
+    if (port_index == 0) {
+        return ((P0 & mask) ? HIGH : LOW);
+    } else if (port_index == 1) {
+        return ((P1 & mask) ? HIGH : LOW);
+    }
+        
+    return 0xFF;
+} // End of digitalRead()
@@ -0,0 +1,703 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "dsp.h"
+
+//----------------------------------------------------------------------------
+// scratch for the assembly kernels
+//----------------------------------------------------------------------------
+
+__data int16_t  dsp_x;
+__data int16_t  dsp_c;
+__data int32_t  dsp_p;
+
+__data uint16_t dsp_x_ptr;
+__data uint16_t dsp_c_ptr;
+__data uint8_t  dsp_count;
+
+//----------------------------------------------------------------------------
+// DSP_ASM_MUL_16X16()
+//
+//      dsp_p = dsp_x * dsp_c, signed 16 x 16 => 32
+//
+//      The four 8 x 8 partial products are done with MUL AB as if both
+//      operands were unsigned, and the result is then corrected for the
+//      sign: a negative operand means 2 ** 16 times the other operand has
+//      to be taken off the upper half. Uses ACC, B and the carry.
+//      Local labels 00010$ and 00011$ are used.
+//----------------------------------------------------------------------------
+
+#define DSP_ASM_MUL_16X16()                          \
+    __asm__ ("mov a, _dsp_x");                       \
+    __asm__ ("mov b, _dsp_c");                       \
+    __asm__ ("mul ab");                              \
+    __asm__ ("mov _dsp_p, a");                       \
+    __asm__ ("mov (_dsp_p + 1), b");                 \
+                                                     \
+    __asm__ ("mov a, (_dsp_x + 1)");                 \
+    __asm__ ("mov b, (_dsp_c + 1)");                 \
+    __asm__ ("mul ab");                              \
+    __asm__ ("mov (_dsp_p + 2), a");                 \
+    __asm__ ("mov (_dsp_p + 3), b");                 \
+                                                     \
+    __asm__ ("mov a, _dsp_x");                       \
+    __asm__ ("mov b, (_dsp_c + 1)");                 \
+    __asm__ ("mul ab");                              \
+    __asm__ ("add a, (_dsp_p + 1)");                 \
+    __asm__ ("mov (_dsp_p + 1), a");                 \
+    __asm__ ("mov a, b");                            \
+    __asm__ ("addc a, (_dsp_p + 2)");                \
+    __asm__ ("mov (_dsp_p + 2), a");                 \
+    __asm__ ("clr a");                               \
+    __asm__ ("addc a, (_dsp_p + 3)");                \
+    __asm__ ("mov (_dsp_p + 3), a");                 \
+                                                     \
+    __asm__ ("mov a, (_dsp_x + 1)");                 \
+    __asm__ ("mov b, _dsp_c");                       \
+    __asm__ ("mul ab");                              \
+    __asm__ ("add a, (_dsp_p + 1)");                 \
+    __asm__ ("mov (_dsp_p + 1), a");                 \
+    __asm__ ("mov a, b");                            \
+    __asm__ ("addc a, (_dsp_p + 2)");                \
+    __asm__ ("mov (_dsp_p + 2), a");                 \
+    __asm__ ("clr a");                               \
+    __asm__ ("addc a, (_dsp_p + 3)");                \
+    __asm__ ("mov (_dsp_p + 3), a");                 \
+                                                     \
+    __asm__ ("mov a, (_dsp_x + 1)");                 \
+    __asm__ ("jnb acc.7, 00010$");                   \
+    __asm__ ("clr c");                               \
+    __asm__ ("mov a, (_dsp_p + 2)");                 \
+    __asm__ ("subb a, _dsp_c");                      \
+    __asm__ ("mov (_dsp_p + 2), a");                 \
+    __asm__ ("mov a, (_dsp_p + 3)");                 \
+    __asm__ ("subb a, (_dsp_c + 1)");                \
+    __asm__ ("mov (_dsp_p + 3), a");                 \
+    __asm__ ("00010$:");                             \
+                                                     \
+    __asm__ ("mov a, (_dsp_c + 1)");                 \
+    __asm__ ("jnb acc.7, 00011$");                   \
+    __asm__ ("clr c");                               \
+    __asm__ ("mov a, (_dsp_p + 2)");                 \
+    __asm__ ("subb a, _dsp_x");                      \
+    __asm__ ("mov (_dsp_p + 2), a");                 \
+    __asm__ ("mov a, (_dsp_p + 3)");                 \
+    __asm__ ("subb a, (_dsp_x + 1)");                \
+    __asm__ ("mov (_dsp_p + 3), a");                 \
+    __asm__ ("00011$:")
+
+
+//----------------------------------------------------------------------------
+// dsp_mul_kernel()
+//
+// Parameters:
+//      None (operands in dsp_x and dsp_c)
+//
+// Return Value:
+//      dsp_x * dsp_c
+//
+// Remarks:
+//      single signed 16 x 16 => 32 multiply
+//----------------------------------------------------------------------------
+
+static q31_t dsp_mul_kernel (void) __naked
+{
+    DSP_ASM_MUL_16X16();
+
+    __asm__ ("mov dpl, _dsp_p");
+    __asm__ ("mov dph, (_dsp_p + 1)");
+    __asm__ ("mov b, (_dsp_p + 2)");
+    __asm__ ("mov a, (_dsp_p + 3)");
+    __asm__ ("ret");
+
+} // End of dsp_mul_kernel()
+
+
+//----------------------------------------------------------------------------
+// dsp_dot_kernel()
+//
+// Parameters:
+//      None (dsp_x_ptr : __xdata samples,
+//            dsp_c_ptr : __code coefficients,
+//            dsp_count : number of taps)
+//
+// Return Value:
+//      sum of sample[i] * coefficient[i]
+//
+// Remarks:
+//      multiply-accumulate loop. R0:R1 walk the samples, R2:R3 walk the
+//      coefficients, and the 32 bit accumulator stays in R4 ~ R7 for the
+//      whole loop. DPTR is reloaded for each operand since there is only
+//      one of it.
+//----------------------------------------------------------------------------
+
+static q31_t dsp_dot_kernel (void) __naked
+{
+    __asm__ ("mov r0, _dsp_x_ptr");
+    __asm__ ("mov r1, (_dsp_x_ptr + 1)");
+    __asm__ ("mov r2, _dsp_c_ptr");
+    __asm__ ("mov r3, (_dsp_c_ptr + 1)");
+
+    __asm__ ("clr a");
+    __asm__ ("mov r4, a");
+    __asm__ ("mov r5, a");
+    __asm__ ("mov r6, a");
+    __asm__ ("mov r7, a");
+
+    __asm__ ("mov a, _dsp_count");
+    __asm__ ("jnz 00001$");
+    __asm__ ("ljmp 00003$");
+
+    __asm__ ("00001$:");
+
+    //== sample from __xdata
+    __asm__ ("mov dpl, r0");
+    __asm__ ("mov dph, r1");
+    __asm__ ("movx a, @dptr");
+    __asm__ ("mov _dsp_x, a");
+    __asm__ ("inc dptr");
+    __asm__ ("movx a, @dptr");
+    __asm__ ("mov (_dsp_x + 1), a");
+    __asm__ ("inc dptr");
+    __asm__ ("mov r0, dpl");
+    __asm__ ("mov r1, dph");
+
+    //== coefficient from __code
+    __asm__ ("mov dpl, r2");
+    __asm__ ("mov dph, r3");
+    __asm__ ("clr a");
+    __asm__ ("movc a, @a+dptr");
+    __asm__ ("mov _dsp_c, a");
+    __asm__ ("mov a, #1");
+    __asm__ ("movc a, @a+dptr");
+    __asm__ ("mov (_dsp_c + 1), a");
+    __asm__ ("inc dptr");
+    __asm__ ("inc dptr");
+    __asm__ ("mov r2, dpl");
+    __asm__ ("mov r3, dph");
+
+    DSP_ASM_MUL_16X16();
+
+    //== accumulate
+    __asm__ ("mov a, r4");
+    __asm__ ("add a, _dsp_p");
+    __asm__ ("mov r4, a");
+    __asm__ ("mov a, r5");
+    __asm__ ("addc a, (_dsp_p + 1)");
+    __asm__ ("mov r5, a");
+    __asm__ ("mov a, r6");
+    __asm__ ("addc a, (_dsp_p + 2)");
+    __asm__ ("mov r6, a");
+    __asm__ ("mov a, r7");
+    __asm__ ("addc a, (_dsp_p + 3)");
+    __asm__ ("mov r7, a");
+
+    // the loop body is too long for a relative jump back
+    __asm__ ("djnz _dsp_count, 00002$");
+    __asm__ ("sjmp 00003$");
+    __asm__ ("00002$:");
+    __asm__ ("ljmp 00001$");
+
+    __asm__ ("00003$:");
+    __asm__ ("mov dpl, r4");
+    __asm__ ("mov dph, r5");
+    __asm__ ("mov b, r6");
+    __asm__ ("mov a, r7");
+    __asm__ ("ret");
+
+} // End of dsp_dot_kernel()
+
+
+//----------------------------------------------------------------------------
+// dsp_mul_16x16()
+//
+// Parameters:
+//      a, b : Q15 operands
+//
+// Return Value:
+//      a * b, Q30
+//
+// Remarks:
+//      signed 16 x 16 => 32 multiply
+//----------------------------------------------------------------------------
+
+q31_t dsp_mul_16x16 (q15_t a, q15_t b)
+{
+    dsp_x = a;
+    dsp_c = b;
+
+    return dsp_mul_kernel();
+
+} // End of dsp_mul_16x16()
+
+
+//----------------------------------------------------------------------------
+// dsp_q30_to_q15()
+//
+// Parameters:
+//      acc : Q30 accumulator
+//
+// Return Value:
+//      acc rounded and saturated to Q15
+//
+// Remarks:
+//      function to bring an accumulator back to sample precision
+//----------------------------------------------------------------------------
+
+q15_t dsp_q30_to_q15 (q31_t acc)
+{
+    acc = (acc + 0x4000) >> 15;
+
+    if (acc > 32767) {
+        return 32767;
+    } else if (acc < -32768) {
+        return -32768;
+    }
+
+    return (q15_t)acc;
+
+} // End of dsp_q30_to_q15()
+
+
+//----------------------------------------------------------------------------
+// dsp_mul_q15()
+//
+// Parameters:
+//      a, b : Q15 operands
+//
+// Return Value:
+//      a * b, rounded and saturated to Q15
+//
+// Remarks:
+//      Q15 multiply
+//----------------------------------------------------------------------------
+
+q15_t dsp_mul_q15 (q15_t a, q15_t b)
+{
+    dsp_x = a;
+    dsp_c = b;
+
+    return dsp_q30_to_q15 (dsp_mul_kernel());
+
+} // End of dsp_mul_q15()
+
+
+//----------------------------------------------------------------------------
+// dsp_q29_to_q15()
+//
+// Parameters:
+//      acc : accumulator of Q15 samples times Q14 coefficients
+//
+// Return Value:
+//      acc rounded and saturated to Q15
+//
+// Remarks:
+//      same as dsp_q30_to_q15(), for Q14 coefficients
+//----------------------------------------------------------------------------
+
+static q15_t dsp_q29_to_q15 (q31_t acc)
+{
+    acc = (acc + 0x2000) >> 14;
+
+    if (acc > 32767) {
+        return 32767;
+    } else if (acc < -32768) {
+        return -32768;
+    }
+
+    return (q15_t)acc;
+
+} // End of dsp_q29_to_q15()
+
+
+//----------------------------------------------------------------------------
+// dsp_fir_init()
+//
+// Parameters:
+//      fir          : filter to initialize
+//      coefficients : h[0] ~ h[taps - 1], Q15
+//      delay        : buffer of 2 * taps samples
+//      taps         : number of taps
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to set up a FIR filter and clear its delay line
+//----------------------------------------------------------------------------
+
+void dsp_fir_init (DSP_FIR_Q15* fir, __code q15_t* coefficients, __xdata q15_t* delay, uint8_t taps)
+{
+    uint16_t i;
+
+    fir->coefficients = coefficients;
+    fir->delay = delay;
+    fir->taps = taps;
+    fir->index = 0;
+
+    for (i = 0; i < (uint16_t)taps * 2; ++i) {
+        delay[i] = 0;
+    } // End of for loop
+
+} // End of dsp_fir_init()
+
+
+//----------------------------------------------------------------------------
+// dsp_fir()
+//
+// Parameters:
+//      fir    : filter
+//      input  : input samples
+//      output : output samples, can be the same buffer as input
+//      count  : number of samples
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to run samples through a FIR filter. Every sample is
+//      written twice into the delay line, so that the newest taps samples
+//      are always contiguous, and the dot product never has to wrap.
+//----------------------------------------------------------------------------
+
+void dsp_fir (DSP_FIR_Q15* fir, q15_t* input, q15_t* output, uint8_t count)
+{
+    __xdata q15_t* delay = fir->delay;
+    uint8_t taps = fir->taps;
+    uint8_t index = fir->index;
+    q15_t sample;
+
+    while (count) {
+        if (index == 0) {
+            index = taps;
+        }
+        --index;
+
+        sample = *input++;
+        delay[index] = sample;
+        delay[index + taps] = sample;
+
+        dsp_x_ptr = (uint16_t)(&delay[index]);
+        dsp_c_ptr = (uint16_t)(fir->coefficients);
+        dsp_count = taps;
+
+        *output++ = dsp_q30_to_q15 (dsp_dot_kernel());
+
+        --count;
+    } // End of while loop
+
+    fir->index = index;
+
+} // End of dsp_fir()
+
+
+//----------------------------------------------------------------------------
+// dsp_biquad_init()
+//
+// Parameters:
+//      biquad       : filter to initialize
+//      coefficients : 5 per stage, {b0, b1, b2, -a1, -a2}, Q14
+//      state        : buffer of 5 * stages samples
+//      stages       : number of second order sections
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to set up a biquad cascade and clear its state
+//----------------------------------------------------------------------------
+
+void dsp_biquad_init (DSP_BIQUAD_Q14* biquad, __code q15_t* coefficients, __xdata q15_t* state, uint8_t stages)
+{
+    uint16_t i;
+
+    biquad->coefficients = coefficients;
+    biquad->state = state;
+    biquad->stages = stages;
+
+    for (i = 0; i < (uint16_t)stages * 5; ++i) {
+        state[i] = 0;
+    } // End of for loop
+
+} // End of dsp_biquad_init()
+
+
+//----------------------------------------------------------------------------
+// dsp_biquad()
+//
+// Parameters:
+//      biquad : filter
+//      input  : input samples
+//      output : output samples, can be the same buffer as input
+//      count  : number of samples
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to run samples through a biquad cascade
+//----------------------------------------------------------------------------
+
+void dsp_biquad (DSP_BIQUAD_Q14* biquad, q15_t* input, q15_t* output, uint8_t count)
+{
+    __xdata q15_t* state;
+    __code q15_t* coefficients;
+    uint8_t stage;
+    q15_t sample;
+
+    while (count) {
+        sample = *input++;
+
+        state = biquad->state;
+        coefficients = biquad->coefficients;
+
+        for (stage = 0; stage < biquad->stages; ++stage) {
+            state[0] = sample;
+
+            dsp_x_ptr = (uint16_t)state;
+            dsp_c_ptr = (uint16_t)coefficients;
+            dsp_count = 5;
+
+            sample = dsp_q29_to_q15 (dsp_dot_kernel());
+
+            state[2] = state[1];
+            state[1] = state[0];
+            state[4] = state[3];
+            state[3] = sample;
+
+            state += 5;
+            coefficients += 5;
+        } // End of for loop
+
+        *output++ = sample;
+        --count;
+    } // End of while loop
+
+} // End of dsp_biquad()
+
+
+//----------------------------------------------------------------------------
+// quarter wave sine table, sin (2 * pi * i / 256), Q15
+//----------------------------------------------------------------------------
+
+static __code q15_t dsp_sine_table [65] = {
+    0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+    6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767
+};
+
+
+//----------------------------------------------------------------------------
+// dsp_fft()
+//
+// Parameters:
+//      data      : 2 ** log2_size complex samples, transformed in place
+//      log2_size : 1 ~ DSP_FFT_MAX_LOG2_SIZE
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      radix-2 decimation in time FFT. Every stage scales by 1/2 so that
+//      nothing overflows, which means the output is the DFT divided by
+//      the FFT size.
+//----------------------------------------------------------------------------
+
+void dsp_fft (__xdata DSP_COMPLEX_Q15* data, uint8_t log2_size)
+{
+    uint16_t size;
+    uint16_t i, j, k, m;
+    uint16_t half, step;
+    uint8_t  twiddle_index, bit;
+    q15_t    w_cos, w_sin;
+    q15_t    tr, ti;
+    DSP_COMPLEX_Q15 temp;
+    __xdata DSP_COMPLEX_Q15* a;
+    __xdata DSP_COMPLEX_Q15* b;
+
+    if ((log2_size == 0) || (log2_size > DSP_FFT_MAX_LOG2_SIZE)) {
+        return;
+    }
+
+    size = (uint16_t)1 << log2_size;
+
+    //== bit reversed reordering
+    for (i = 0; i < size; ++i) {
+        j = 0;
+        m = i;
+        for (bit = 0; bit < log2_size; ++bit) {
+            j = (j << 1) | (m & 1);
+            m >>= 1;
+        } // End of for loop
+
+        if (i < j) {
+            temp = data[i];
+            data[i] = data[j];
+            data[j] = temp;
+        }
+    } // End of for loop
+
+    //== butterflies
+    step = (uint16_t)1 << (DSP_FFT_MAX_LOG2_SIZE - 1);
+
+    for (half = 1; half < size; half <<= 1) {
+        for (k = 0; k < half; ++k) {
+            // W = cos (2 * pi * k / (2 * half)) - j * sin (...)
+            twiddle_index = (uint8_t)(k * step);
+
+            if (twiddle_index <= 64) {
+                w_cos = dsp_sine_table[64 - twiddle_index];
+                w_sin = dsp_sine_table[twiddle_index];
+            } else {
+                w_cos = -dsp_sine_table[twiddle_index - 64];
+                w_sin = dsp_sine_table[128 - twiddle_index];
+            }
+
+            for (i = k; i < size; i += (half << 1)) {
+                a = &data[i];
+                b = &data[i + half];
+
+                // t = W * b
+                tr = dsp_q30_to_q15 (dsp_mul_16x16 (b->re, w_cos) + dsp_mul_16x16 (b->im, w_sin));
+                ti = dsp_q30_to_q15 (dsp_mul_16x16 (b->im, w_cos) - dsp_mul_16x16 (b->re, w_sin));
+
+                b->re = (q15_t)(((q31_t)a->re - tr) >> 1);
+                b->im = (q15_t)(((q31_t)a->im - ti) >> 1);
+                a->re = (q15_t)(((q31_t)a->re + tr) >> 1);
+                a->im = (q15_t)(((q31_t)a->im + ti) >> 1);
+            } // End of for loop
+        } // End of for loop
+
+        step >>= 1;
+    } // End of for loop
+
+} // End of dsp_fft()
+
+
+//----------------------------------------------------------------------------
+// dsp_goertzel_init()
+//
+// Parameters:
+//      goertzel    : detector to initialize
+//      coefficient : 2 * cos (2 * pi * k / N), Q14
+//      input_shift : right shift applied to the input samples
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to set up a Goertzel detector and clear its state
+//----------------------------------------------------------------------------
+
+void dsp_goertzel_init (DSP_GOERTZEL_Q14* goertzel, q15_t coefficient, uint8_t input_shift)
+{
+    goertzel->coefficient = coefficient;
+    goertzel->input_shift = input_shift;
+    goertzel->s1 = 0;
+    goertzel->s2 = 0;
+
+} // End of dsp_goertzel_init()
+
+
+//----------------------------------------------------------------------------
+// dsp_goertzel()
+//
+// Parameters:
+//      goertzel : detector
+//      input    : input samples
+//      count    : number of samples
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to run samples through the Goertzel resonator,
+//      s[n] = x[n] + coefficient * s[n-1] - s[n-2]
+//----------------------------------------------------------------------------
+
+void dsp_goertzel (DSP_GOERTZEL_Q14* goertzel, q15_t* input, uint8_t count)
+{
+    q15_t s0;
+    q15_t s1 = goertzel->s1;
+    q15_t s2 = goertzel->s2;
+    uint8_t input_shift = goertzel->input_shift;
+
+    while (count) {
+        dsp_x = goertzel->coefficient;
+        dsp_c = s1;
+
+        s0 = dsp_q29_to_q15 (dsp_mul_kernel() + ((((q31_t)(*input++ >> input_shift)) - s2) << 14));
+
+        s2 = s1;
+        s1 = s0;
+        --count;
+    } // End of while loop
+
+    goertzel->s1 = s1;
+    goertzel->s2 = s2;
+
+} // End of dsp_goertzel()
+
+
+//----------------------------------------------------------------------------
+// dsp_goertzel_power()
+//
+// Parameters:
+//      goertzel : detector
+//
+// Return Value:
+//      s1 * s1 + s2 * s2 - coefficient * s1 * s2, Q30
+//
+// Remarks:
+//      function to read the squared magnitude of the bin. The state is
+//      cleared for the next block.
+//----------------------------------------------------------------------------
+
+q31_t dsp_goertzel_power (DSP_GOERTZEL_Q14* goertzel)
+{
+    q31_t power;
+    q15_t s1 = goertzel->s1;
+    q15_t s2 = goertzel->s2;
+
+    // coefficient * s1 is kept in 32 bits (Q15, up to twice full scale),
+    // as saturating it to Q15 would clip any |s1| above 0.5 when the
+    // coefficient is close to 2.0
+    power = dsp_mul_16x16 (s1, s1) + dsp_mul_16x16 (s2, s2) -
+            (dsp_mul_16x16 (goertzel->coefficient, s1) >> 14) * s2;
+
+    goertzel->s1 = 0;
+    goertzel->s2 = 0;
+
+    return power;
+
+} // End of dsp_goertzel_power()
@@ -0,0 +1,103 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef DSP_H
+#define DSP_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Fixed-point DSP kernels
+//
+// Samples are Q15 (int16_t), products and accumulators are Q30 in 32 bits.
+// The 16 x 16 multiply and the FIR / biquad inner loop are written in
+// assembly around MUL AB, with the accumulator kept in R4 ~ R7. The
+// kernels share a few bytes of scratch in __data, so they must not be
+// called from an ISR while the main loop is using them.
+//============================================================================================
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+typedef struct {
+    q15_t re;
+    q15_t im;
+} DSP_COMPLEX_Q15;
+
+//----------------------------------------------------------------------------
+// FIR filter
+//  coefficients : h[0] ~ h[taps - 1], Q15, in __code
+//  delay        : 2 * taps samples in __xdata, cleared by dsp_fir_init()
+//----------------------------------------------------------------------------
+
+typedef struct {
+    __code q15_t*  coefficients;
+    __xdata q15_t* delay;
+    uint8_t taps;
+    uint8_t index;
+} DSP_FIR_Q15;
+
+//----------------------------------------------------------------------------
+// biquad cascade, direct form I
+//  coefficients : 5 per stage, {b0, b1, b2, -a1, -a2}, Q14, in __code
+//                 (the feedback terms are stored negated)
+//  state        : 5 per stage, {x[n], x[n-1], x[n-2], y[n-1], y[n-2]}, in
+//                 __xdata, so each stage is one 5 tap dot product
+//----------------------------------------------------------------------------
+
+typedef struct {
+    __code q15_t*  coefficients;
+    __xdata q15_t* state;
+    uint8_t stages;
+} DSP_BIQUAD_Q14;
+
+//----------------------------------------------------------------------------
+// Goertzel single bin detector
+//  coefficient : 2 * cos (2 * pi * k / N), Q14
+//  input_shift : input samples are shifted right by this much to leave
+//                headroom for the resonator
+//----------------------------------------------------------------------------
+
+typedef struct {
+    q15_t coefficient;
+    q15_t s1;
+    q15_t s2;
+    uint8_t input_shift;
+} DSP_GOERTZEL_Q14;
+
+#define DSP_FFT_MAX_LOG2_SIZE 8
+
+extern q31_t dsp_mul_16x16 (q15_t a, q15_t b);
+extern q15_t dsp_mul_q15 (q15_t a, q15_t b);
+extern q15_t dsp_q30_to_q15 (q31_t acc);
+
+extern void dsp_fir_init (DSP_FIR_Q15* fir, __code q15_t* coefficients, __xdata q15_t* delay, uint8_t taps);
+extern void dsp_fir (DSP_FIR_Q15* fir, q15_t* input, q15_t* output, uint8_t count);
+
+extern void dsp_biquad_init (DSP_BIQUAD_Q14* biquad, __code q15_t* coefficients, __xdata q15_t* state, uint8_t stages);
+extern void dsp_biquad (DSP_BIQUAD_Q14* biquad, q15_t* input, q15_t* output, uint8_t count);
+
+extern void dsp_fft (__xdata DSP_COMPLEX_Q15* data, uint8_t log2_size);
+
+extern void dsp_goertzel_init (DSP_GOERTZEL_Q14* goertzel, q15_t coefficient, uint8_t input_shift);
+extern void dsp_goertzel (DSP_GOERTZEL_Q14* goertzel, q15_t* input, uint8_t count);
+extern q31_t dsp_goertzel_power (DSP_GOERTZEL_Q14* goertzel);
+
+#endif
@@ -0,0 +1,400 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+// handlers set by attachIsrHandler()
+void (*codec_isr_handler_pointer)();
+void (*adc_isr_handler_pointer)();
+void (*int1_i2c_isr_handler_pointer)();
+void (*int0_isr_handler_pointer)();
+void (*timer0_isr_handler_pointer)();
+
+// per-sample CODEC handler, see __codec_isr()
+__data ISR_HANDLER_POINTER codec_fast_isr_pointer = 0;
+
+
+//----------------------------------------------------------------------------
+// codec_isr()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      ISR for CODEC. If codec_fast_isr_pointer is set, the ISR jumps to it
+//      with only ACC, DPL and DPH pushed, and the fast handler is
+//      responsible for popping them and doing the reti. Otherwise the
+//      handler set by attachIsrHandler() is called with all registers saved.
+//----------------------------------------------------------------------------
+
+void __codec_isr () __interrupt (CODEC_INT_INDEX) __naked
+{
+     __asm__ ("nop");
+     __asm__ ("nop");
+     __asm__ ("nop");
+     
+     __asm__ ("push acc");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     
+     __asm__ ("mov a, _codec_fast_isr_pointer");
+     __asm__ ("orl a, (_codec_fast_isr_pointer + 1)");
+     __asm__ ("jz 00001$");
+     
+     __asm__ ("mov dpl, _codec_fast_isr_pointer");
+     __asm__ ("mov dph, (_codec_fast_isr_pointer + 1)");
+     __asm__ ("clr a");
+     __asm__ ("jmp @a+dptr");
+     
+     __asm__ ("00001$:");
+     __asm__ ("pop dph");
+     __asm__ ("pop dpl");
+     __asm__ ("pop acc");
+ 
+     __asm__ ("push psw");
+     __asm__ ("push acc");
+     __asm__ ("push b");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     __asm__ ("push ar0");
+     __asm__ ("push ar1");
+     __asm__ ("push ar2");
+     __asm__ ("push ar3");
+     __asm__ ("push ar4");
+     __asm__ ("push ar5");
+     __asm__ ("push ar6");
+     __asm__ ("push ar7");
+
+    
+      __asm__ ("nop");
+
+#ifdef ISR_PROFILE
+      isr_profile_enter (CODEC_INT_INDEX);
+#endif
+
+      if (codec_isr_handler_pointer) {
+            codec_isr_handler_pointer();
+      }
+
+#ifdef ISR_PROFILE
+      isr_profile_exit (CODEC_INT_INDEX);
+#endif
+      
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+      
+      __asm__ ("pop ar7");
+      __asm__ ("pop ar6");
+      __asm__ ("pop ar5");
+      __asm__ ("pop ar4");
+      __asm__ ("pop ar3");
+      __asm__ ("pop ar2");
+      __asm__ ("pop ar1");
+      __asm__ ("pop ar0");
+
+      __asm__ ("pop dph");
+      __asm__ ("pop dpl");
+      __asm__ ("pop b");
+      __asm__ ("pop acc");
+      __asm__ ("pop psw");
+     
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+            
+      __asm__ ("reti");
+
+} // End of codec_isr()
+
+
+void __adc_isr (void) __interrupt (ADC_INT_INDEX) __naked
+{
+  
+     __asm__ ("nop");
+     __asm__ ("nop");
+     __asm__ ("nop");
+ 
+     __asm__ ("push psw");
+     __asm__ ("push acc");
+     __asm__ ("push b");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     __asm__ ("push ar0");
+     __asm__ ("push ar1");
+     __asm__ ("push ar2");
+     __asm__ ("push ar3");
+     __asm__ ("push ar4");
+     __asm__ ("push ar5");
+     __asm__ ("push ar6");
+     __asm__ ("push ar7");
+
+    
+      __asm__ ("nop");
+
+#ifdef ISR_PROFILE
+      isr_profile_enter (ADC_INT_INDEX);
+#endif
+
+      if (adc_isr_handler_pointer) {
+            adc_isr_handler_pointer();
+      }
+
+#ifdef ISR_PROFILE
+      isr_profile_exit (ADC_INT_INDEX);
+#endif
+      
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+      
+      __asm__ ("pop ar7");
+      __asm__ ("pop ar6");
+      __asm__ ("pop ar5");
+      __asm__ ("pop ar4");
+      __asm__ ("pop ar3");
+      __asm__ ("pop ar2");
+      __asm__ ("pop ar1");
+      __asm__ ("pop ar0");
+
+      __asm__ ("pop dph");
+      __asm__ ("pop dpl");
+      __asm__ ("pop b");
+      __asm__ ("pop acc");
+      __asm__ ("pop psw");
+     
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+            
+      __asm__ ("reti");
+  
+    
+
+} // End of adc_isr()
+
+
+
+void __int1_i2c__isr (void) __interrupt (INT1_I2C_INT_INDEX) __naked
+{
+  
+     __asm__ ("nop");
+     __asm__ ("nop");
+     __asm__ ("nop");
+ 
+     __asm__ ("push psw");
+     __asm__ ("push acc");
+     __asm__ ("push b");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     __asm__ ("push ar0");
+     __asm__ ("push ar1");
+     __asm__ ("push ar2");
+     __asm__ ("push ar3");
+     __asm__ ("push ar4");
+     __asm__ ("push ar5");
+     __asm__ ("push ar6");
+     __asm__ ("push ar7");
+
+    
+      __asm__ ("nop");
+
+#ifdef ISR_PROFILE
+      isr_profile_enter (INT1_I2C_INT_INDEX);
+#endif
+
+      if (int1_i2c_isr_handler_pointer) {
+            int1_i2c_isr_handler_pointer();
+      }
+
+#ifdef ISR_PROFILE
+      isr_profile_exit (INT1_I2C_INT_INDEX);
+#endif
+      
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+      
+      __asm__ ("pop ar7");
+      __asm__ ("pop ar6");
+      __asm__ ("pop ar5");
+      __asm__ ("pop ar4");
+      __asm__ ("pop ar3");
+      __asm__ ("pop ar2");
+      __asm__ ("pop ar1");
+      __asm__ ("pop ar0");
+
+      __asm__ ("pop dph");
+      __asm__ ("pop dpl");
+      __asm__ ("pop b");
+      __asm__ ("pop acc");
+      __asm__ ("pop psw");
+     
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+            
+      __asm__ ("reti");
+  
+    
+
+} // End of __int1_i2c__isr()
+
+
+void __int0_isr (void) __interrupt (INT0_INT_INDEX) __naked
+{
+  
+     __asm__ ("nop");
+     __asm__ ("nop");
+     __asm__ ("nop");
+ 
+     __asm__ ("push psw");
+     __asm__ ("push acc");
+     __asm__ ("push b");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     __asm__ ("push ar0");
+     __asm__ ("push ar1");
+     __asm__ ("push ar2");
+     __asm__ ("push ar3");
+     __asm__ ("push ar4");
+     __asm__ ("push ar5");
+     __asm__ ("push ar6");
+     __asm__ ("push ar7");
+
+    
+      __asm__ ("nop");
+
+#ifdef ISR_PROFILE
+      isr_profile_enter (INT0_INT_INDEX);
+#endif
+
+      if (int0_isr_handler_pointer) {
+            int0_isr_handler_pointer();
+      }
+
+#ifdef ISR_PROFILE
+      isr_profile_exit (INT0_INT_INDEX);
+#endif
+      
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+      
+      __asm__ ("pop ar7");
+      __asm__ ("pop ar6");
+      __asm__ ("pop ar5");
+      __asm__ ("pop ar4");
+      __asm__ ("pop ar3");
+      __asm__ ("pop ar2");
+      __asm__ ("pop ar1");
+      __asm__ ("pop ar0");
+
+      __asm__ ("pop dph");
+      __asm__ ("pop dpl");
+      __asm__ ("pop b");
+      __asm__ ("pop acc");
+      __asm__ ("pop psw");
+     
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+            
+      __asm__ ("reti");
+  
+    
+
+} // End of __int0_isr()
+
+void __timer0_isr (void) __interrupt (TIMER0_INT_INDEX) __naked
+{
+  
+     __asm__ ("nop");
+     __asm__ ("nop");
+     __asm__ ("nop");
+ 
+     __asm__ ("push psw");
+     __asm__ ("push acc");
+     __asm__ ("push b");
+     __asm__ ("push dpl");
+     __asm__ ("push dph");
+     __asm__ ("push ar0");
+     __asm__ ("push ar1");
+     __asm__ ("push ar2");
+     __asm__ ("push ar3");
+     __asm__ ("push ar4");
+     __asm__ ("push ar5");
+     __asm__ ("push ar6");
+     __asm__ ("push ar7");
+
+    
+      __asm__ ("nop");
+
+#ifdef ISR_PROFILE
+      isr_profile_enter (TIMER0_INT_INDEX);
+#endif
+
+      if (timer0_isr_handler_pointer) {
+            timer0_isr_handler_pointer();
+      }
+
+#ifdef ISR_PROFILE
+      isr_profile_exit (TIMER0_INT_INDEX);
+#endif
+      
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+      
+      __asm__ ("pop ar7");
+      __asm__ ("pop ar6");
+      __asm__ ("pop ar5");
+      __asm__ ("pop ar4");
+      __asm__ ("pop ar3");
+      __asm__ ("pop ar2");
+      __asm__ ("pop ar1");
+      __asm__ ("pop ar0");
+
+      __asm__ ("pop dph");
+      __asm__ ("pop dpl");
+      __asm__ ("pop b");
+      __asm__ ("pop acc");
+      __asm__ ("pop psw");
+     
+      __asm__ ("nop");
+      __asm__ ("nop");
+      __asm__ ("nop");
+            
+      __asm__ ("reti");
+  
+    
+
+} // End of __timer0_isr()
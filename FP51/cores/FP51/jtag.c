@@ -0,0 +1,291 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "jtag.h"
+
+#include "wiring_private.h"
+
+static __xdata uint8_t jtag_tx_buffer [JTAG_BUFFER_SIZE];
+
+// head is only written by the main loop, tail only by jtag_tx_drain()
+static __data volatile uint8_t jtag_tx_head = 0;
+static __data volatile uint8_t jtag_tx_tail = 0;
+
+static uint16_t jtag_dropped_count = 0;
+
+//----------------------------------------------------------------------------
+// jtag_tx_drain()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      per tick handler of timer1_isr(), to send one byte from the buffer
+//      when the JTAG UART can take it
+//----------------------------------------------------------------------------
+
+static void jtag_tx_drain ()
+{
+    if ((jtag_tx_tail != jtag_tx_head) && (JTAG_UART & JTAG_UART_TX_READY)) {
+        JTAG_UART = jtag_tx_buffer[jtag_tx_tail];
+        jtag_tx_tail = (jtag_tx_tail + 1) & JTAG_BUFFER_MASK;
+    }
+
+} // End of jtag_tx_drain()
+
+
+//----------------------------------------------------------------------------
+// jtag_install()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to hook jtag_tx_drain() into timer1_isr(), the interrupt
+//      enable is kept as it was. With FAST_BOOT, Timer 1 is started here
+//      (with Serial) if nothing has started it yet, or the buffer would
+//      never drain.
+//----------------------------------------------------------------------------
+
+static void jtag_install ()
+{
+    uint8_t ea;
+
+    SERIAL_LAZY_BEGIN();
+
+    ea = EA;
+    EA = 0;
+    timer1_jtag_handler_pointer = jtag_tx_drain;
+    EA = ea;
+
+} // End of jtag_install()
+
+
+//----------------------------------------------------------------------------
+// jtag_put_char()
+//
+// Parameters:
+//      c : byte to send
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to queue a byte for the JTAG UART. It never waits, and the
+//      byte is dropped if the buffer is full. The drain is installed on
+//      first use, as Log is often used without begin().
+//----------------------------------------------------------------------------
+
+void jtag_put_char (uint8_t c)
+{
+    uint8_t head = jtag_tx_head;
+    uint8_t next = (head + 1) & JTAG_BUFFER_MASK;
+
+    if (!timer1_jtag_handler_pointer) {
+        jtag_install ();
+    }
+
+    if (next == jtag_tx_tail) {
+        ++jtag_dropped_count;
+    } else {
+        jtag_tx_buffer[head] = c;
+        jtag_tx_head = next;
+    }
+
+} // End of jtag_put_char()
+
+
+//----------------------------------------------------------------------------
+// jtag_dropped()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of bytes dropped because the buffer was full
+//
+// Remarks:
+//      function to read the dropped byte counter
+//----------------------------------------------------------------------------
+
+uint16_t jtag_dropped ()
+{
+    return jtag_dropped_count;
+
+} // End of jtag_dropped()
+
+
+//----------------------------------------------------------------------------
+// jtag_print_int()
+//
+// Parameters:
+//      num     : 32 bit number, to be printed in ascii
+//      printer : num_to_dec, num_to_hex, num_to_oct or num_to_bin
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to print a 32 bit number to the JTAG UART in ascii code
+//----------------------------------------------------------------------------
+
+static void jtag_print_int (int32_t num, NUM_TO_ASCII printer) __reentrant
+{
+    uint8_t *p = printer (num);
+
+    while (*p) {
+        jtag_put_char (*p++);
+    }
+
+} // End of jtag_print_int()
+
+
+//----------------------------------------------------------------------------
+// jtag_printLn()
+//
+// Parameters:
+//      data    : 32 bit data to be printed
+//      printer : num_to_dec, num_to_hex, num_to_oct or num_to_bin
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to print a 32 bit number to the JTAG UART in ascii code,
+//      plus new line
+//----------------------------------------------------------------------------
+
+static void jtag_printLn (int32_t data, NUM_TO_ASCII printer) __reentrant
+{
+    jtag_print_int (data, printer);
+    jtag_put_char ('\n');
+
+} // End of jtag_printLn()
+
+
+//----------------------------------------------------------------------------
+// jtag_write()
+//
+// Parameters:
+//      buf    : pointer to the data buffer
+//      length : the number of bytes valid in the buffer, 0 for a
+//               null-terminated string
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to queue a buffer for the JTAG UART
+//----------------------------------------------------------------------------
+
+static void jtag_write (uint8_t* buf, uint16_t length) __reentrant
+{
+    if (length) {
+        while (length) {
+            jtag_put_char ((*buf++));
+            --length;
+        } // End of while loop
+    } else {
+        while (*buf) {
+            jtag_put_char ((*buf++));
+        } // End of while loop
+    }
+
+} // End of jtag_write()
+
+
+//----------------------------------------------------------------------------
+// input side of JtagSerial, the console is output only
+//----------------------------------------------------------------------------
+
+static void jtag_begin (uint32_t rate)
+{
+    (void)rate;
+
+    jtag_install ();
+
+} // End of jtag_begin()
+
+static uint8_t jtag_available ()
+{
+    return 0;
+
+} // End of jtag_available()
+
+static uint8_t jtag_read ()
+{
+    return 0;
+
+} // End of jtag_read()
+
+static uint8_t jtag_read_bytes (uint8_t* buf, uint16_t length) __reentrant
+{
+    (void)buf;
+    (void)length;
+
+    return 0xFF;
+
+} // End of jtag_read_bytes()
+
+static void jtag_set_timeout (uint32_t time_out_in_ms)
+{
+    (void)time_out_in_ms;
+
+} // End of jtag_set_timeout()
+
+static uint8_t jtag_read_line (uint8_t* buf, uint16_t max_length) __reentrant
+{
+    (void)buf;
+    (void)max_length;
+
+    return 0;
+
+} // End of jtag_read_line()
+
+static void jtag_end ()
+{
+    uint8_t ea = EA;
+
+    EA = 0;
+    timer1_jtag_handler_pointer = 0;
+    jtag_tx_tail = jtag_tx_head;
+    EA = ea;
+
+} // End of jtag_end()
+
+
+const SERIAL_STRUCT JtagSerial = {jtag_begin, jtag_available,
+                                  jtag_print_int, jtag_printLn,
+                                  jtag_put_char, jtag_read, jtag_read_bytes,
+                                  jtag_write, jtag_set_timeout, jtag_read_line, jtag_end};
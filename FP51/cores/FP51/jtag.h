@@ -0,0 +1,62 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#ifndef JTAG_H
+#define JTAG_H
+
+#include "common_type.h"
+
+//============================================================================================
+// JTAG UART console
+//
+// Output to the JTAG UART goes into a ring buffer, which is drained one
+// byte per tick by a handler that the first write (or begin()) installs
+// in timer1_isr(), so sketches that never use it don't link it. Writes
+// never wait: when the buffer is full (no debugger attached, for
+// example), the bytes are dropped and counted. With FAST_BOOT, Timer 1
+// only runs once Serial is started, so installing the drain starts
+// Serial too. JtagSerial has the same interface as Serial, and Log is the
+// one to use for debug output, so it can be moved back to the main UART
+// by building with LOG_TO_SERIAL.
+//============================================================================================
+
+#ifndef JTAG_BUFFER_SIZE
+#define JTAG_BUFFER_SIZE 128
+#endif
+
+// the ring buffer index wraps with a mask
+C_ASSERT((JTAG_BUFFER_SIZE & (JTAG_BUFFER_SIZE - 1)) == 0);
+C_ASSERT(JTAG_BUFFER_SIZE <= 256);
+
+#define JTAG_BUFFER_MASK (JTAG_BUFFER_SIZE - 1)
+
+extern void jtag_put_char (uint8_t c);
+extern uint16_t jtag_dropped ();
+
+extern const SERIAL_STRUCT JtagSerial;
+
+#ifdef LOG_TO_SERIAL
+    #define Log Serial
+#else
+    #define Log JtagSerial
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// millis()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of milliseconds passed since reset
+//
+// Remarks:
+//      function to keep track of time since reset
+//----------------------------------------------------------------------------
+
+uint32_t millis ()
+{
+    uint32_t temp;
+    
+    SERIAL_LAZY_BEGIN();
+    
+    EA = 0;
+    temp = timer1_big_tick;
+    EA = 1;
+    
+    // num_of_tick * 868 * 256 /100e6 * 1000
+    // num_of_tick * 868 * 256 /96e6 * 1000
+    
+    return ((temp * serial_rate_factor) / 375);
+} // End of millis()
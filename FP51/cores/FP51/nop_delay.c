@@ -0,0 +1,70 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// single_nop_delay()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to delay by one nop
+//----------------------------------------------------------------------------
+
+void single_nop_delay()
+{
+     __asm__ ("nop");
+} // End of single_nop_delay
+
+//----------------------------------------------------------------------------
+// nop_delay()
+//
+// Parameters:
+//      num : number of nops
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to delay by a number of nops
+//----------------------------------------------------------------------------
+
+void nop_delay(uint8_t num)
+{
+    uint8_t i;
+    
+    for (i = 0; i < num; ++i) {
+       __asm__ ("nop");
+    } // End of for loop
+    
+} // End of nop_delay
@@ -0,0 +1,62 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+static uint8_t num_to_bin_buf [33];
+
+//----------------------------------------------------------------------------
+// num_to_bin()
+//
+// Parameters:
+//      num : 32 bit number, converted as unsigned
+//
+// Return Value:
+//      pointer to the binary digits, NUL terminated, in a static buffer that
+//      the next call overwrites
+//
+// Remarks:
+//      the BIN printer behind Serial.print() and JtagSerial.print(). Kept in
+//      a file of its own, so only the radix a sketch prints is linked.
+//----------------------------------------------------------------------------
+
+uint8_t* num_to_bin (int32_t num)
+{
+    uint32_t value = (uint32_t)num;
+    uint8_t *p = num_to_bin_buf + sizeof(num_to_bin_buf) - 1;
+    
+    *p = 0;
+    
+    do {
+        *--p = digital_to_ascii ((uint8_t)(value & 0x1));
+        value >>= 1;
+    } while (value);
+    
+    return p;
+    
+} // End of num_to_bin()
@@ -20,6 +20,20 @@
 #ifndef PERIPHERALS_H
 #define PERIPHERALS_H
 
+//============================================================================================
+// JTAG UART
+//  JTAG_UART (write) : byte to be sent to the host
+//  JTAG_UART (read)  : bit 0 is set when the write FIFO can take another
+//                      byte. The FIFO is only drained while a host is
+//                      attached, so it stays full without a debugger.
+//
+// Not from the FP51 TRM, which only gives the address of JTAG_UART and
+// leaves the rest to the M10JTAG TRM (not in docs/). The ready bit is an
+// assumption. jtag.c only ever writes data bytes, so if it is wrong, the
+// console loses output, but nothing else is affected.
+//============================================================================================
+
+#define JTAG_UART_TX_READY      0x01
 
 
 #endif
@@ -0,0 +1,63 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// pinMode()
+//
+// Parameters:
+//      pin   : pin index
+//      mode  : INPUT or OUTPUT
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to set pin mode as INPUT or OUTPUT
+//----------------------------------------------------------------------------
+
+void pinMode (uint8_t pin, uint8_t mode)
+{
+    uint8_t port_index = (pin >> 3);
+    uint8_t mask = 1 << (pin & 7);
+    
+    if (port_index == 0) {
+        if (mode) {
+            P0_DIRECTION = P0_DIRECTION | mask; 
+        } else {
+            P0_DIRECTION = P0_DIRECTION & (~mask); 
+        }
+    } else if (port_index == 1) {
+        if (mode) {
+            P1_DIRECTION = P1_DIRECTION | mask; 
+        } else {
+            P1_DIRECTION = P1_DIRECTION & (~mask); 
+        }
+    }        
+} // End of pinMode()
@@ -0,0 +1,575 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "profile.h"
+
+static __xdata uint32_t profile_start [PROFILE_NUM_OF_REGIONS];
+static __xdata uint32_t profile_min [PROFILE_NUM_OF_REGIONS];
+static __xdata uint32_t profile_max [PROFILE_NUM_OF_REGIONS];
+static __xdata uint32_t profile_total [PROFILE_NUM_OF_REGIONS];
+static __xdata uint32_t profile_count [PROFILE_NUM_OF_REGIONS];
+
+static __data volatile uint16_t profile_overflow_count;
+static uint32_t profile_overhead = 0;
+static uint8_t profile_timer_running = 0;
+
+static __xdata uint16_t isr_profile_start [ISR_PROFILE_NUM_OF_VECTORS];
+static __xdata uint32_t isr_profile_count [ISR_PROFILE_NUM_OF_VECTORS];
+static __xdata uint32_t isr_profile_total [ISR_PROFILE_NUM_OF_VECTORS];
+static __xdata uint16_t isr_profile_histogram [ISR_PROFILE_NUM_OF_VECTORS][ISR_PROFILE_NUM_OF_BUCKETS];
+static __xdata uint16_t isr_profile_latency [ISR_PROFILE_NUM_OF_BUCKETS];
+static uint32_t isr_profile_reset_time;
+static uint8_t isr_profile_active = 0;
+
+//----------------------------------------------------------------------------
+// profile_timer0_overflow()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      TIMER0 handler, extends Timer 0 to 32 bits
+//----------------------------------------------------------------------------
+
+static void profile_timer0_overflow ()
+{
+    ++profile_overflow_count;
+
+} // End of profile_timer0_overflow()
+
+
+//----------------------------------------------------------------------------
+// profile_now()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of CPU cycles since profile_begin(), wraps every 44 seconds
+//
+// Remarks:
+//      function to read the 32 bit cycle counter. TH0 is read twice in case
+//      TL0 carries into it, and an overflow not served yet (TF0 still set)
+//      is added by hand. The interrupt enable is restored, not set, so
+//      it can be used inside a critical section.
+//----------------------------------------------------------------------------
+
+uint32_t profile_now ()
+{
+    uint16_t high;
+    uint8_t th, tl;
+    uint8_t ea = EA;
+
+    EA = 0;
+
+    th = TH0;
+    tl = TL0;
+    if (th != TH0) {
+        th = TH0;
+        tl = TL0;
+    }
+
+    high = profile_overflow_count;
+    if ((TF0) && (!(th & 0x80))) {
+        ++high;
+    }
+
+    EA = ea;
+
+    return (((uint32_t)high << 16) | ((uint16_t)th << 8) | tl);
+
+} // End of profile_now()
+
+
+//----------------------------------------------------------------------------
+// profile_reset()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to clear the statistics of all the regions
+//----------------------------------------------------------------------------
+
+void profile_reset ()
+{
+    uint8_t i;
+
+    for (i = 0; i < PROFILE_NUM_OF_REGIONS; ++i) {
+        profile_min[i] = 0xFFFFFFFF;
+        profile_max[i] = 0;
+        profile_total[i] = 0;
+        profile_count[i] = 0;
+    } // End of for loop
+
+} // End of profile_reset()
+
+
+//----------------------------------------------------------------------------
+// profile_timer_start()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to start Timer 0 free running (mode 1, 16 bit) with the
+//      overflow handler attached, shared by both profilers
+//----------------------------------------------------------------------------
+
+static void profile_timer_start ()
+{
+    if (profile_timer_running) {
+        return;
+    }
+
+    TR0 = 0;
+    TMOD = (TMOD & 0xF0) | 0x01;
+    TH0 = 0;
+    TL0 = 0;
+    TF0 = 0;
+
+    profile_overflow_count = 0;
+    attachIsrHandler (TIMER0_INT_INDEX, profile_timer0_overflow);
+
+    TR0 = 1;
+
+    profile_timer_running = 1;
+
+} // End of profile_timer_start()
+
+
+//----------------------------------------------------------------------------
+// profile_begin()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to start the cycle counter, and to measure the cost of an
+//      empty PROFILE_BEGIN / PROFILE_END pair
+//----------------------------------------------------------------------------
+
+void profile_begin ()
+{
+    uint8_t i;
+
+    profile_timer_start ();
+
+    profile_overhead = 0;
+    profile_reset ();
+
+    for (i = 0; i < 4; ++i) {
+        profile_region_begin (0);
+        profile_region_end (0);
+    } // End of for loop
+
+    profile_overhead = profile_min[0];
+    profile_reset ();
+
+} // End of profile_begin()
+
+
+//----------------------------------------------------------------------------
+// profile_region_begin()
+//
+// Parameters:
+//      id : region, 0 ~ (PROFILE_NUM_OF_REGIONS - 1)
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function behind PROFILE_BEGIN()
+//----------------------------------------------------------------------------
+
+void profile_region_begin (uint8_t id)
+{
+    if (id < PROFILE_NUM_OF_REGIONS) {
+        profile_start[id] = profile_now ();
+    }
+
+} // End of profile_region_begin()
+
+
+//----------------------------------------------------------------------------
+// profile_region_end()
+//
+// Parameters:
+//      id : region, 0 ~ (PROFILE_NUM_OF_REGIONS - 1)
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function behind PROFILE_END()
+//----------------------------------------------------------------------------
+
+void profile_region_end (uint8_t id)
+{
+    uint32_t cycles = profile_now ();
+
+    if (id >= PROFILE_NUM_OF_REGIONS) {
+        return;
+    }
+
+    cycles -= profile_start[id];
+
+    if (cycles > profile_overhead) {
+        cycles -= profile_overhead;
+    } else {
+        cycles = 0;
+    }
+
+    if (cycles < profile_min[id]) {
+        profile_min[id] = cycles;
+    }
+
+    if (cycles > profile_max[id]) {
+        profile_max[id] = cycles;
+    }
+
+    profile_total[id] += cycles;
+    ++profile_count[id];
+
+} // End of profile_region_end()
+
+
+//----------------------------------------------------------------------------
+// profile_dump()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to print the regions that have been hit, one per line:
+//          PROFILE id count total min max
+//      all in hex, cycles for the last three
+//----------------------------------------------------------------------------
+
+void profile_dump ()
+{
+    uint8_t i;
+
+    Serial.write ("PROFILE_DUMP_BEGIN\n");
+
+    for (i = 0; i < PROFILE_NUM_OF_REGIONS; ++i) {
+        if (profile_count[i]) {
+            Serial.write ("PROFILE ");
+            Serial.print (i, HEX);
+            Serial.write (" ");
+            Serial.print (profile_count[i], HEX);
+            Serial.write (" ");
+            Serial.print (profile_total[i], HEX);
+            Serial.write (" ");
+            Serial.print (profile_min[i], HEX);
+            Serial.write (" ");
+            Serial.println (profile_max[i], HEX);
+        }
+    } // End of for loop
+
+    Serial.write ("PROFILE_DUMP_END\n");
+
+} // End of profile_dump()
+
+
+//----------------------------------------------------------------------------
+// profile_service()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to be called from loop() when the sketch does not use the
+//      serial input itself. PROFILE_DUMP_COMMAND dumps the regions and
+//      clears them.
+//----------------------------------------------------------------------------
+
+void profile_service ()
+{
+    if ((Serial.available ()) && (Serial.read () == PROFILE_DUMP_COMMAND)) {
+        profile_dump ();
+        profile_reset ();
+
+        if (isr_profile_active) {
+            isr_profile_dump ();
+            isr_profile_reset ();
+        }
+    }
+
+} // End of profile_service()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_begin()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to start the cycle counter and clear the ISR statistics.
+//      Nothing is recorded unless the core is built with ISR_PROFILE.
+//----------------------------------------------------------------------------
+
+void isr_profile_begin ()
+{
+    profile_timer_start ();
+    isr_profile_reset ();
+
+    isr_profile_active = 1;
+
+} // End of isr_profile_begin()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_reset()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to clear the ISR statistics, the interrupt enable is
+//      kept as it was
+//----------------------------------------------------------------------------
+
+void isr_profile_reset ()
+{
+    uint8_t i, j;
+    uint8_t ea = EA;
+
+    EA = 0;
+
+    for (i = 0; i < ISR_PROFILE_NUM_OF_VECTORS; ++i) {
+        isr_profile_count[i] = 0;
+        isr_profile_total[i] = 0;
+
+        for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+            isr_profile_histogram[i][j] = 0;
+        } // End of for loop
+    } // End of for loop
+
+    for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+        isr_profile_latency[j] = 0;
+    } // End of for loop
+
+    EA = ea;
+
+    isr_profile_reset_time = profile_now ();
+
+} // End of isr_profile_reset()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_bucket()
+//
+// Parameters:
+//      cycles : duration
+//
+// Return Value:
+//      number of significant bits in cycles, 0 ~ 16
+//
+// Remarks:
+//      function to find the log2 bucket of a duration
+//----------------------------------------------------------------------------
+
+static uint8_t isr_profile_bucket (uint16_t cycles)
+{
+    uint8_t bucket = 0;
+
+    while (cycles) {
+        ++bucket;
+        cycles >>= 1;
+    } // End of while loop
+
+    return bucket;
+
+} // End of isr_profile_bucket()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_enter()
+//
+// Parameters:
+//      index : interrupt index
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      called by the ISR trampolines before the handler
+//----------------------------------------------------------------------------
+
+void isr_profile_enter (uint8_t index)
+{
+    uint8_t th, tl;
+
+    th = TH0;
+    tl = TL0;
+    if (th != TH0) {
+        th = TH0;
+        tl = TL0;
+    }
+
+    isr_profile_start[index] = ((uint16_t)th << 8) | tl;
+
+    if (index == TIMER0_INT_INDEX) {
+        ++isr_profile_latency[isr_profile_bucket (isr_profile_start[index])];
+    }
+
+} // End of isr_profile_enter()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_exit()
+//
+// Parameters:
+//      index : interrupt index
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      called by the ISR trampolines after the handler
+//----------------------------------------------------------------------------
+
+void isr_profile_exit (uint8_t index)
+{
+    uint8_t th, tl;
+    uint16_t cycles;
+
+    th = TH0;
+    tl = TL0;
+    if (th != TH0) {
+        th = TH0;
+        tl = TL0;
+    }
+
+    cycles = (((uint16_t)th << 8) | tl) - isr_profile_start[index];
+
+    ++isr_profile_count[index];
+    isr_profile_total[index] += cycles;
+    ++isr_profile_histogram[index][isr_profile_bucket (cycles)];
+
+} // End of isr_profile_exit()
+
+
+//----------------------------------------------------------------------------
+// isr_profile_dump()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to print the ISR statistics, all in hex:
+//          ISR_ELAPSED cycles since the last reset
+//          ISR index count total bucket0 ~ bucket16     (vectors hit)
+//          ISR_LATENCY bucket0 ~ bucket16               (TIMER0 only)
+//      Each vector is copied with interrupts off, then printed. The
+//      interrupt enable is put back as it was on entry.
+//----------------------------------------------------------------------------
+
+void isr_profile_dump ()
+{
+    uint8_t i, j;
+    uint8_t ea = EA;
+    uint32_t count, total;
+    uint16_t histogram [ISR_PROFILE_NUM_OF_BUCKETS];
+
+    Serial.write ("ISR_DUMP_BEGIN\n");
+
+    Serial.write ("ISR_ELAPSED ");
+    Serial.println (profile_now () - isr_profile_reset_time, HEX);
+
+    for (i = 0; i < ISR_PROFILE_NUM_OF_VECTORS; ++i) {
+        EA = 0;
+        count = isr_profile_count[i];
+        total = isr_profile_total[i];
+        for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+            histogram[j] = isr_profile_histogram[i][j];
+        } // End of for loop
+        EA = ea;
+
+        if (count) {
+            Serial.write ("ISR ");
+            Serial.print (i, HEX);
+            Serial.write (" ");
+            Serial.print (count, HEX);
+            Serial.write (" ");
+            Serial.print (total, HEX);
+
+            for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+                Serial.write (" ");
+                Serial.print (histogram[j], HEX);
+            } // End of for loop
+
+            Serial.write ("\n");
+        }
+    } // End of for loop
+
+    EA = 0;
+    for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+        histogram[j] = isr_profile_latency[j];
+    } // End of for loop
+    EA = ea;
+
+    Serial.write ("ISR_LATENCY");
+    for (j = 0; j < ISR_PROFILE_NUM_OF_BUCKETS; ++j) {
+        Serial.write (" ");
+        Serial.print (histogram[j], HEX);
+    } // End of for loop
+    Serial.write ("\n");
+
+    Serial.write ("ISR_DUMP_END\n");
+
+} // End of isr_profile_dump()
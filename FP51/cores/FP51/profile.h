@@ -0,0 +1,90 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Cycle profiler
+//
+// Timer 0 runs free at the CPU clock, and its overflows are counted in the
+// TIMER0 handler to make a 32 bit cycle counter. PROFILE_BEGIN(id) and
+// PROFILE_END(id) time a region of the main loop (not of an ISR), and
+// the min / max / total / count of each region are kept in __xdata, with
+// the cost of the macros themselves taken off. profile_dump() prints the
+// regions over Serial, and tools/profile_report.py turns that into a
+// table. Build with PROFILE_DISABLE to compile the macros out.
+//============================================================================================
+
+#ifndef PROFILE_NUM_OF_REGIONS
+#define PROFILE_NUM_OF_REGIONS 16
+#endif
+
+C_ASSERT(PROFILE_NUM_OF_REGIONS <= 255);
+
+// byte on Serial that makes profile_service() dump the regions (and the
+// ISR statistics, if isr_profile_begin() has been called)
+#define PROFILE_DUMP_COMMAND 'P'
+
+extern void profile_begin ();
+extern void profile_reset ();
+
+extern uint32_t profile_now ();
+extern void profile_region_begin (uint8_t id);
+extern void profile_region_end (uint8_t id);
+
+extern void profile_dump ();
+extern void profile_service ();
+
+//============================================================================================
+// ISR profiler
+//
+// When the core is built with ISR_PROFILE, the ISR trampolines in M10.c
+// and timer1_isr() call isr_profile_enter() / isr_profile_exit() around
+// the handler, and the time spent in each vector is kept as a total and
+// as a histogram of log2 buckets (bucket n counts durations of n bits,
+// i.e. 2 ** (n - 1) ~ 2 ** n - 1 cycles). For TIMER0, the counter value on
+// entry is also the time since the overflow, which gives a latency
+// histogram as well. The timestamps are the lower 16 bits of the Timer 0
+// cycle counter, and all vectors are assumed to be at the same priority
+// (the default), so they never nest.
+//============================================================================================
+
+#define ISR_PROFILE_NUM_OF_VECTORS 7
+#define ISR_PROFILE_NUM_OF_BUCKETS 17
+
+extern void isr_profile_begin ();
+extern void isr_profile_reset ();
+extern void isr_profile_enter (uint8_t index);
+extern void isr_profile_exit (uint8_t index);
+extern void isr_profile_dump ();
+
+#ifdef PROFILE_DISABLE
+    #define PROFILE_BEGIN(id)
+    #define PROFILE_END(id)
+#else
+    #define PROFILE_BEGIN(id) profile_region_begin (id)
+    #define PROFILE_END(id)   profile_region_end (id)
+#endif
+
+#endif
@@ -0,0 +1,371 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+#include "serial_line.h"
+
+static __xdata uint8_t serial_rx_buffer [SERIAL_RX_BUFFER_SIZE];
+
+// head is only written by serial_rx_isr(), tail only by the main loop
+static __data volatile uint8_t serial_rx_head = 0;
+static __data volatile uint8_t serial_rx_tail = 0;
+
+static volatile uint16_t serial_rx_dropped_count = 0;
+
+static uint8_t* serial_line_buffer;
+static uint8_t  serial_line_max_length;
+static uint8_t* serial_line_terminators;
+static uint16_t serial_line_timeout;
+static uint32_t serial_line_start_time;
+static uint8_t  serial_line_count;
+static uint8_t  serial_line_status;
+
+//----------------------------------------------------------------------------
+// serial_rx_isr()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      per tick handler of timer1_isr(), to move a received byte from SBUF
+//      into the receive buffer
+//----------------------------------------------------------------------------
+
+static void serial_rx_isr ()
+{
+    if (RI) {
+        if (((serial_rx_head + 1) & SERIAL_RX_BUFFER_MASK) != serial_rx_tail) {
+            serial_rx_buffer[serial_rx_head] = SBUF;
+            serial_rx_head = (serial_rx_head + 1) & SERIAL_RX_BUFFER_MASK;
+        } else {
+            ++serial_rx_dropped_count;
+        }
+
+        RI = 0;
+    }
+
+} // End of serial_rx_isr()
+
+
+//----------------------------------------------------------------------------
+// serial_rx_ready()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      1 if the receive buffer is not empty, 0 if it is
+//
+// Remarks:
+//      function to check the receive buffer, for Serial
+//----------------------------------------------------------------------------
+
+static uint8_t serial_rx_ready ()
+{
+    return (serial_rx_head != serial_rx_tail);
+
+} // End of serial_rx_ready()
+
+
+//----------------------------------------------------------------------------
+// serial_rx_read()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the oldest byte in the receive buffer, 0 if the buffer is empty
+//
+// Remarks:
+//      function to take one byte out of the receive buffer
+//----------------------------------------------------------------------------
+
+uint8_t serial_rx_read ()
+{
+    uint8_t c;
+    uint8_t tail = serial_rx_tail;
+
+    if (tail == serial_rx_head) {
+        return 0;
+    }
+
+    c = serial_rx_buffer[tail];
+    serial_rx_tail = (tail + 1) & SERIAL_RX_BUFFER_MASK;
+
+    return c;
+
+} // End of serial_rx_read()
+
+
+//----------------------------------------------------------------------------
+// serial_rx_dropped()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of bytes dropped because the receive buffer was full
+//
+// Remarks:
+//      function to read the dropped byte counter
+//----------------------------------------------------------------------------
+
+uint16_t serial_rx_dropped ()
+{
+    uint16_t temp;
+    uint8_t ea = EA;
+
+    EA = 0;
+    temp = serial_rx_dropped_count;
+    EA = ea;
+
+    return temp;
+
+} // End of serial_rx_dropped()
+
+
+//----------------------------------------------------------------------------
+// serial_line_begin()
+//
+// Parameters:
+//      buf           : buffer for the line
+//      max_length    : size of buf, including the NUL at the end (>= 2)
+//      terminators   : NUL terminated string of the bytes that end a line,
+//                      0 for SERIAL_LINE_DEFAULT_TERMINATORS
+//      timeout_in_ms : deadline for a line, counted from its first byte. A
+//                      partial line is returned once it has passed, even
+//                      if bytes are still coming in. 0 to wait for the
+//                      terminator forever
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to start buffering the serial input, and to set up the
+//      line assembly
+//----------------------------------------------------------------------------
+
+void serial_line_begin (uint8_t* buf, uint8_t max_length, uint8_t* terminators, uint16_t timeout_in_ms)
+{
+    uint8_t ea;
+
+    if (terminators == 0) {
+        terminators = (uint8_t*)SERIAL_LINE_DEFAULT_TERMINATORS;
+    }
+
+    serial_line_buffer = buf;
+    serial_line_max_length = max_length;
+    serial_line_terminators = terminators;
+    serial_line_timeout = timeout_in_ms;
+    serial_line_count = 0;
+    serial_line_status = SERIAL_LINE_NONE;
+
+    ea = EA;
+    EA = 0;
+
+    serial_rx_head = 0;
+    serial_rx_tail = 0;
+    serial_rx_dropped_count = 0;
+
+    RI = 0;
+    REN = 1;
+
+    serial_rx_ready_pointer = serial_rx_ready;
+    serial_rx_read_pointer = serial_rx_read;
+    timer1_serial_rx_handler_pointer = serial_rx_isr;
+
+    EA = ea;
+
+} // End of serial_line_begin()
+
+
+//----------------------------------------------------------------------------
+// serial_line_is_terminator()
+//
+// Parameters:
+//      c : received byte
+//
+// Return Value:
+//      1 if c ends a line, 0 if not
+//
+// Remarks:
+//      function to look a byte up in the terminator string
+//----------------------------------------------------------------------------
+
+static uint8_t serial_line_is_terminator (uint8_t c)
+{
+    uint8_t* t = serial_line_terminators;
+
+    while (*t) {
+        if (*t == c) {
+            return 1;
+        }
+        ++t;
+    } // End of while loop
+
+    return 0;
+
+} // End of serial_line_is_terminator()
+
+
+//----------------------------------------------------------------------------
+// serial_line_finish()
+//
+// Parameters:
+//      status : SERIAL_LINE_READY, SERIAL_LINE_TIMEOUT or
+//               SERIAL_LINE_OVERFLOW
+//
+// Return Value:
+//      status
+//
+// Remarks:
+//      function to NUL terminate the line and hand it over
+//----------------------------------------------------------------------------
+
+static uint8_t serial_line_finish (uint8_t status)
+{
+    serial_line_buffer[serial_line_count] = 0;
+    serial_line_status = status;
+
+    return status;
+
+} // End of serial_line_finish()
+
+
+//----------------------------------------------------------------------------
+// serial_line_poll()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      SERIAL_LINE_NONE     : the line is not complete yet
+//      SERIAL_LINE_READY    : a terminator came in
+//      SERIAL_LINE_TIMEOUT  : the deadline of a partial line passed
+//      SERIAL_LINE_OVERFLOW : the line filled the buffer, the rest of it
+//                             comes as the next line
+//
+// Remarks:
+//      function to assemble the line from the receive buffer, without
+//      waiting. Call it from loop().
+//----------------------------------------------------------------------------
+
+uint8_t serial_line_poll ()
+{
+    uint8_t c;
+
+    if (serial_line_status != SERIAL_LINE_NONE) {
+        serial_line_count = 0;
+        serial_line_status = SERIAL_LINE_NONE;
+    }
+
+    // serial_putchar() turns the receiver off
+    if (REN == 0) {
+        REN = 1;
+    }
+
+    while (serial_rx_tail != serial_rx_head) {
+        c = serial_rx_read ();
+
+        if (serial_line_is_terminator (c)) {
+            if (serial_line_count) {
+                return serial_line_finish (SERIAL_LINE_READY);
+            }
+        } else {
+            if (serial_line_count == 0) {
+                serial_line_start_time = millis ();
+            }
+
+            serial_line_buffer[serial_line_count] = c;
+            ++serial_line_count;
+
+            if (serial_line_count >= (serial_line_max_length - 1)) {
+                return serial_line_finish (SERIAL_LINE_OVERFLOW);
+            }
+        }
+    } // End of while loop
+
+    if (serial_line_count && serial_line_timeout) {
+        if ((millis () - serial_line_start_time) >= serial_line_timeout) {
+            return serial_line_finish (SERIAL_LINE_TIMEOUT);
+        }
+    }
+
+    return SERIAL_LINE_NONE;
+
+} // End of serial_line_poll()
+
+
+//----------------------------------------------------------------------------
+// serial_line_length()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      number of bytes in the line, not counting the NUL
+//
+// Remarks:
+//      function to read the length of the line serial_line_poll() handed
+//      over
+//----------------------------------------------------------------------------
+
+uint8_t serial_line_length ()
+{
+    return serial_line_count;
+
+} // End of serial_line_length()
+
+
+//----------------------------------------------------------------------------
+// serial_line_end()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to stop buffering the serial input, Serial goes back to
+//      reading SBUF directly
+//----------------------------------------------------------------------------
+
+void serial_line_end ()
+{
+    uint8_t ea = EA;
+
+    EA = 0;
+    timer1_serial_rx_handler_pointer = 0;
+    serial_rx_ready_pointer = 0;
+    serial_rx_read_pointer = 0;
+    EA = ea;
+
+} // End of serial_line_end()
@@ -0,0 +1,70 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef SERIAL_LINE_H
+#define SERIAL_LINE_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Buffered serial input and line assembly
+//
+// serial_line_begin() installs a handler in timer1_isr() that moves each
+// received byte from SBUF into a ring buffer (it runs several times per
+// byte time, so SBUF never overruns), and points Serial.available() /
+// Serial.read() / Serial.readBytes() at the buffer as well. Neither
+// refers to this file directly, so it is only linked when used.
+//
+// serial_line_poll() never waits: it moves what has been received into
+// the line, and tells whether the line is complete. A line ends at any of
+// the terminator bytes (the terminator is not kept), when it fills the
+// buffer, or when the timeout has passed since its first byte (a deadline
+// for the whole line, so one that trickles in still ends). Empty lines are
+// skipped, so "\r\n" counts as one terminator. The line in the buffer is
+// always NUL terminated, and the next poll starts a new one.
+//============================================================================================
+
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64
+#endif
+
+// the ring buffer index wraps with a mask
+C_ASSERT((SERIAL_RX_BUFFER_SIZE & (SERIAL_RX_BUFFER_SIZE - 1)) == 0);
+C_ASSERT(SERIAL_RX_BUFFER_SIZE <= 256);
+
+#define SERIAL_RX_BUFFER_MASK (SERIAL_RX_BUFFER_SIZE - 1)
+
+#define SERIAL_LINE_DEFAULT_TERMINATORS "\r\n"
+
+// serial_line_poll() return values
+#define SERIAL_LINE_NONE     0
+#define SERIAL_LINE_READY    1
+#define SERIAL_LINE_TIMEOUT  2
+#define SERIAL_LINE_OVERFLOW 3
+
+extern uint8_t serial_rx_read ();
+extern uint16_t serial_rx_dropped ();
+
+extern void serial_line_begin (uint8_t* buf, uint8_t max_length, uint8_t* terminators, uint16_t timeout_in_ms);
+extern uint8_t serial_line_poll ();
+extern uint8_t serial_line_length ();
+extern void serial_line_end ();
+
+#endif
@@ -0,0 +1,295 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "stack.h"
+
+#ifdef __SDCC_USE_XSTACK
+// start of the xstack, defined by the startup code
+extern __xdata uint8_t _start__xstack;
+#endif
+
+#define STACK_IDATA_TOP (STACK_IDATA_LOCATION + STACK_IDATA_SIZE - 1)
+
+// return address pushed by the call to stack_push_pattern()
+#define STACK_CALL_OVERHEAD 2
+
+// scratch for the assembly helpers
+__data uint16_t stack_sp_top;
+__data uint16_t stack_byte_count;
+__data uint16_t stack_untouched_count;
+__data uint8_t  stack_saved_spl;
+__data uint8_t  stack_saved_sph;
+__data uint8_t  stack_pattern = STACK_PAINT_PATTERN;
+
+// limits for STACK_CHECK, out of reach until stack_paint() sets them
+__data uint16_t stack_check_idata_limit = 0xFFFF;
+__data uint8_t  stack_check_xstack_limit = 0xFF;
+__data volatile uint8_t stack_warning_flags = 0;
+
+//----------------------------------------------------------------------------
+// stack_push_pattern()
+//
+// Parameters:
+//      None (stack_byte_count : number of bytes to paint)
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to push the pattern stack_byte_count times above the
+//      current SP (which already holds the return address of the call),
+//      and then put SP back. Interrupts must be off.
+//----------------------------------------------------------------------------
+
+static void stack_push_pattern (void) __naked
+{
+    __asm__ ("mov _stack_saved_spl, sp");
+    __asm__ ("mov _stack_saved_sph, _SPH");
+
+    __asm__ ("mov a, _stack_byte_count");
+    __asm__ ("orl a, (_stack_byte_count + 1)");
+    __asm__ ("jz 00002$");
+
+    __asm__ ("mov r6, _stack_byte_count");
+    __asm__ ("mov r7, (_stack_byte_count + 1)");
+    __asm__ ("mov a, r6");
+    __asm__ ("jz 00001$");
+    __asm__ ("inc r7");
+
+    __asm__ ("00001$:");
+    __asm__ ("push _stack_pattern");
+    __asm__ ("djnz r6, 00001$");
+    __asm__ ("djnz r7, 00001$");
+
+    __asm__ ("00002$:");
+    __asm__ ("mov _SPH, _stack_saved_sph");
+    __asm__ ("mov sp, _stack_saved_spl");
+    __asm__ ("ret");
+
+} // End of stack_push_pattern()
+
+
+//----------------------------------------------------------------------------
+// stack_pop_pattern()
+//
+// Parameters:
+//      None (stack_sp_top     : the highest painted address,
+//            stack_byte_count : number of bytes to look at)
+//
+// Return Value:
+//      None (stack_untouched_count : number of bytes, from the top down,
+//            that still hold the pattern)
+//
+// Remarks:
+//      function to move SP to the top of the painted area and pop down
+//      until a byte no longer holds the pattern, then put SP back.
+//      Interrupts must be off.
+//----------------------------------------------------------------------------
+
+static void stack_pop_pattern (void) __naked
+{
+    __asm__ ("mov _stack_saved_spl, sp");
+    __asm__ ("mov _stack_saved_sph, _SPH");
+
+    __asm__ ("clr a");
+    __asm__ ("mov _stack_untouched_count, a");
+    __asm__ ("mov (_stack_untouched_count + 1), a");
+
+    __asm__ ("mov a, _stack_byte_count");
+    __asm__ ("orl a, (_stack_byte_count + 1)");
+    __asm__ ("jz 00003$");
+
+    __asm__ ("mov r6, _stack_byte_count");
+    __asm__ ("mov r7, (_stack_byte_count + 1)");
+    __asm__ ("mov a, r6");
+    __asm__ ("jz 00001$");
+    __asm__ ("inc r7");
+
+    __asm__ ("00001$:");
+    __asm__ ("mov _SPH, (_stack_sp_top + 1)");
+    __asm__ ("mov sp, _stack_sp_top");
+
+    __asm__ ("00002$:");
+    __asm__ ("pop acc");
+    __asm__ ("cjne a, _stack_pattern, 00003$");
+    __asm__ ("inc _stack_untouched_count");
+    __asm__ ("mov a, _stack_untouched_count");
+    __asm__ ("jnz 00004$");
+    __asm__ ("inc (_stack_untouched_count + 1)");
+    __asm__ ("00004$:");
+    __asm__ ("djnz r6, 00002$");
+    __asm__ ("djnz r7, 00002$");
+
+    __asm__ ("00003$:");
+    __asm__ ("mov _SPH, _stack_saved_sph");
+    __asm__ ("mov sp, _stack_saved_spl");
+    __asm__ ("ret");
+
+} // End of stack_pop_pattern()
+
+
+//----------------------------------------------------------------------------
+// stack_paint()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to paint both stacks above where they are now, and to set
+//      the limits for STACK_CHECK. The interrupt enable is kept as it was,
+//      main() calls it before setup() with interrupts still off.
+//----------------------------------------------------------------------------
+
+void stack_paint ()
+{
+    uint16_t sp;
+#ifdef __SDCC_USE_XSTACK
+    uint16_t xstack_page;
+    __xdata uint8_t* p;
+#endif
+    uint8_t ea = EA;
+
+    EA = 0;
+
+    sp = ((uint16_t)SPH << 8) | SP;
+
+    // the call pushes its return address before the first pattern byte
+    if ((sp + STACK_CALL_OVERHEAD) < STACK_IDATA_TOP) {
+        stack_byte_count = STACK_IDATA_TOP - sp - STACK_CALL_OVERHEAD;
+        stack_push_pattern ();
+    }
+
+    EA = ea;
+
+#ifdef __SDCC_USE_XSTACK
+    xstack_page = (uint16_t)(&_start__xstack) & 0xFF00;
+
+    for (p = (__xdata uint8_t*)(xstack_page | spx); ; ++p) {
+        *p = STACK_PAINT_PATTERN;
+        if (((uint16_t)p & 0xFF) == 0xFF) {
+            break;
+        }
+    } // End of for loop
+#endif
+
+    stack_check_idata_limit = STACK_IDATA_TOP - STACK_CHECK_MARGIN;
+    stack_check_xstack_limit = 0xFF - STACK_CHECK_MARGIN;
+
+} // End of stack_paint()
+
+
+//----------------------------------------------------------------------------
+// stack_idata_peak()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the most bytes of hardware stack used so far, counted from
+//      STACK_IDATA_LOCATION
+//
+// Remarks:
+//      function to find the high water mark of the hardware stack
+//----------------------------------------------------------------------------
+
+uint16_t stack_idata_peak ()
+{
+    uint16_t untouched;
+    uint8_t ea = EA;
+
+    EA = 0;
+
+    stack_sp_top = STACK_IDATA_TOP;
+    stack_byte_count = STACK_IDATA_SIZE;
+    stack_pop_pattern ();
+    untouched = stack_untouched_count;
+
+    EA = ea;
+
+    return (STACK_IDATA_SIZE - untouched);
+
+} // End of stack_idata_peak()
+
+
+//----------------------------------------------------------------------------
+// stack_xstack_peak()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the most bytes of xstack used so far, 0 without --xstack
+//
+// Remarks:
+//      function to find the high water mark of the xstack
+//----------------------------------------------------------------------------
+
+uint8_t stack_xstack_peak ()
+{
+#ifdef __SDCC_USE_XSTACK
+    uint8_t start = (uint8_t)((uint16_t)(&_start__xstack) & 0xFF);
+    uint8_t i = 0xFF;
+    __xdata uint8_t* page = (__xdata uint8_t*)((uint16_t)(&_start__xstack) & 0xFF00);
+
+    while (page[i] == STACK_PAINT_PATTERN) {
+        if (i == start) {
+            return 0;
+        }
+        --i;
+    } // End of while loop
+
+    return (i - start + 1);
+#else
+    return 0;
+#endif
+
+} // End of stack_xstack_peak()
+
+
+//----------------------------------------------------------------------------
+// stack_warning()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      STACK_WARNING_IDATA and / or STACK_WARNING_XSTACK if a stack has
+//      come within STACK_CHECK_MARGIN bytes of its end, 0 otherwise
+//
+// Remarks:
+//      function to read the flags set by STACK_CHECK in timer1_isr()
+//----------------------------------------------------------------------------
+
+uint8_t stack_warning ()
+{
+    return stack_warning_flags;
+
+} // End of stack_warning()
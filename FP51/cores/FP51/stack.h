@@ -0,0 +1,83 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+
+#ifndef STACK_H
+#define STACK_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Stack high water marks
+//
+// stack_paint() (called first thing in main()) fills the unused part of
+// the hardware stack and of the xstack with STACK_PAINT_PATTERN. The
+// hardware stack grows up from --stack-loc with the 16 bit SP (SPH:SP),
+// and the xstack (--xstack) grows up from __start__xstack to the end of
+// its 256 byte page, with _spx as its pointer. stack_idata_peak() and
+// stack_xstack_peak() find the highest byte that has been overwritten.
+//
+// When the core is built with STACK_CHECK, timer1_isr() also samples
+// both stack pointers, and stack_warning() becomes non-zero once either
+// of them gets within STACK_CHECK_MARGIN bytes of its end.
+//
+// The memory models without --xstack (--m10-model, see compiler_dispatch)
+// have no xstack, and stack_xstack_peak() is always 0 there.
+//============================================================================================
+
+// --stack-loc of the build. compiler_dispatch passes it with -D, from the
+// memory model or from --m10-stack, and 126 is the default of the large
+// models for builds that do not.
+#ifndef STACK_IDATA_LOCATION
+#define STACK_IDATA_LOCATION 126
+#endif
+
+// bytes of hardware stack painted and checked, from STACK_IDATA_LOCATION
+#ifndef STACK_IDATA_SIZE
+#define STACK_IDATA_SIZE 256
+#endif
+
+#ifndef STACK_CHECK_MARGIN
+#define STACK_CHECK_MARGIN 16
+#endif
+
+C_ASSERT(STACK_CHECK_MARGIN < STACK_IDATA_SIZE);
+
+#define STACK_PAINT_PATTERN 0xAA
+
+#define STACK_WARNING_IDATA  0x01
+#define STACK_WARNING_XSTACK 0x02
+
+#ifdef __SDCC_USE_XSTACK
+extern __data uint8_t spx;
+#endif
+
+extern __data uint16_t stack_check_idata_limit;
+extern __data uint8_t stack_check_xstack_limit;
+extern __data volatile uint8_t stack_warning_flags;
+
+extern void stack_paint ();
+
+extern uint16_t stack_idata_peak ();
+extern uint8_t stack_xstack_peak ();
+
+extern uint8_t stack_warning ();
+
+#endif
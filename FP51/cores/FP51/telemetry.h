@@ -0,0 +1,65 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Binary telemetry
+//
+// A record is {type, sequence, payload, CRC-16 (MSB first)}, COBS encoded
+// and terminated by 0x00 on Serial. The CRC is CRC-16/CCITT-FALSE (poly
+// 0x1021, init 0xFFFF) over type, sequence and payload, with the table in
+// __code. The record is at most 253 bytes, so the encoding is at most one
+// byte longer. Bytes go straight from the caller's buffer to the UART,
+// nothing is copied.
+//
+// Serial.writeByte() waits (on TI) for each byte to go out, so
+// telemetry_send() blocks for the whole frame: about 10 bit times per
+// encoded byte, plus the CRC and the COBS overhead. That, not the
+// encoding, is what limits the samples per second, so pack several
+// samples into one record and use the highest baud rate the host takes.
+//
+// The payload is an array of elements of the same layout, and the type
+// tells the layout. Multi-byte values are little endian, as SDCC keeps
+// them in memory. tools/telemetry_decode.py turns the stream into one
+// file per field (column).
+//============================================================================================
+
+#define TELEMETRY_MAX_PAYLOAD 249
+
+// predefined types, payload is an array of ...
+#define TELEMETRY_TYPE_U16 0x01
+#define TELEMETRY_TYPE_S16 0x02
+#define TELEMETRY_TYPE_U32 0x03
+#define TELEMETRY_TYPE_S32 0x04
+
+// types from TELEMETRY_TYPE_USER on are for sketches to define
+#define TELEMETRY_TYPE_USER 0x80
+
+#define TELEMETRY_CRC16_INIT 0xFFFF
+
+extern uint16_t telemetry_crc16 (uint16_t crc, uint8_t* buf, uint8_t length);
+
+extern void telemetry_send (uint8_t type, uint8_t* payload, uint8_t length);
+
+#endif
@@ -0,0 +1,113 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or 
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#include "8051.h"
+
+#include "debug.h"
+#include "common_type.h"
+#include "peripherals.h"
+
+#include "Arduino.h"
+#include "wiring_private.h"
+
+
+//----------------------------------------------------------------------------
+// dog_kick()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      watch dog kick
+//----------------------------------------------------------------------------
+                              
+void dog_kick() 
+{
+    __asm__ ("mov 192, #1");
+} // End of dog_kick()
+
+// Timer 1 reload, see wiring_private.h
+uint32_t serial_rate_factor = 833; // 96e6 / 115200 
+
+// tick counter
+uint8_t timer1_small_tick = 0;
+uint32_t timer1_big_tick = 0;
+
+// per tick work of the optional modules, see wiring_private.h
+void (*timer1_serial_rx_handler_pointer)() = 0;
+void (*timer1_jtag_handler_pointer)() = 0;
+
+//----------------------------------------------------------------------------
+// timer1_isr()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      ISR for timer, also runs the per tick handlers the optional modules
+//      have installed
+//----------------------------------------------------------------------------
+
+void timer1_isr (void) __interrupt (3)
+{
+#ifdef ISR_PROFILE
+    isr_profile_enter (TIMER1_INT_INDEX);
+#endif
+
+   //== dog_kick();
+    __asm__ ("mov 192, #1"); // direct dog kick 
+    
+    ++timer1_small_tick;
+    if (timer1_small_tick == 127) {
+        ++timer1_big_tick;
+
+#ifdef STACK_CHECK
+        if ((((uint16_t)SPH << 8) | SP) > stack_check_idata_limit) {
+            stack_warning_flags |= STACK_WARNING_IDATA;
+        }
+
+#ifdef __SDCC_USE_XSTACK
+        if (spx > stack_check_xstack_limit) {
+            stack_warning_flags |= STACK_WARNING_XSTACK;
+        }
+#endif
+#endif
+    }
+    
+    //== move a received byte into the receive buffer, see serial_line.h
+    if (timer1_serial_rx_handler_pointer) {
+        timer1_serial_rx_handler_pointer();
+    }
+    
+    //== drain the JTAG UART console, see jtag.h
+    if (timer1_jtag_handler_pointer) {
+        timer1_jtag_handler_pointer();
+    }
+
+#ifdef ISR_PROFILE
+    isr_profile_exit (TIMER1_INT_INDEX);
+#endif
+} // End of timer1_isr()
@@ -0,0 +1,103 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License (LGPL) as 
+# published by the Free Software Foundation, either version 3 of the License,
+# or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but 
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+# or FITNESS FOR A PARTICULAR PURPOSE.  
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+#ifndef WIRING_PRIVATE_H
+#define WIRING_PRIVATE_H
+
+#include "common_type.h"
+
+//============================================================================================
+// Core internals shared by the modules M10.c was split into
+//
+// sdld links whole .rel files, and pulls a .rel out of core.a only when
+// something in it is referenced. So the core is kept in one file per
+// function where it can be:
+//
+//      M10.c           : Serial (all of it, as the Serial table refers to
+//                        every function in it), except for
+//      num_to_dec.c    : num_to_dec(), the DEC printer
+//      num_to_hex.c    : num_to_hex(), the HEX printer
+//      num_to_oct.c    : num_to_oct(), the OCT printer
+//      num_to_bin.c    : num_to_bin(), the BIN printer, which print() and
+//                        println() pass in, so only the radix used is linked
+//      pin_mode.c      : pinMode()
+//      digital_write.c : digitalWrite()
+//      digital_read.c  : digitalRead()
+//      ascii.c         : digital_to_ascii()
+//      delay.c         : delay()
+//      delay_us.c      : delayMicroseconds()
+//      nop_delay.c     : nop_delay(), single_nop_delay()
+//      timer1.c        : timer1_isr(), dog_kick()
+//      millis.c        : millis()
+//      micros.c        : micros()
+//      interrupts.c    : interrupts(), noInterrupts()
+//      attach_isr.c    : attachIsrHandler()
+//      isr.c           : the other interrupt service routines
+//
+// main.c holds the vector table, so timer1_isr() and the ISRs in isr.c are
+// linked into every sketch, along with whatever they refer to. They must
+// not call into optional modules such as jtag.c or serial_line.c. Those
+// install a handler pointer (below) when they are first used.
+//
+// Keep new code in a file of its own unless it is always used together
+// with an existing one. Nothing here is for sketches.
+//============================================================================================
+
+// Timer 1 reload, in CPU cycles per serial bit. Set by Serial.begin(), and
+// the time base of delay() and millis().
+extern uint32_t serial_rate_factor;
+
+// Timer 1 ticks, big tick = 127 small ticks
+extern uint8_t timer1_small_tick;
+extern uint32_t timer1_big_tick;
+
+extern void serial_begin (uint32_t rate);
+
+// Called by timer1_isr() on every tick when set. A module that needs
+// per tick work installs its handler here when it is first used, so
+// timer1_isr() (always linked) never refers to it directly. Set with EA
+// cleared, as the pointer is two bytes.
+extern void (*timer1_serial_rx_handler_pointer)();
+extern void (*timer1_jtag_handler_pointer)();
+
+// Receive side of Serial while serial_line.c buffers the input, 0 when
+// Serial reads SBUF directly. Installed by serial_line_begin().
+extern uint8_t (*serial_rx_ready_pointer)();
+extern uint8_t (*serial_rx_read_pointer)();
+
+extern void (*adc_isr_handler_pointer)();
+extern void (*int1_i2c_isr_handler_pointer)();
+extern void (*int0_isr_handler_pointer)();
+extern void (*timer0_isr_handler_pointer)();
+
+#ifdef FAST_BOOT
+
+// Serial (with Timer 1) starts on first use, see boot.h
+extern __data uint8_t serial_started;
+
+#define SERIAL_LAZY_BEGIN() if (!serial_started) { serial_begin (SERIAL_DEFAULT_BAUD_RATE); }
+
+#else
+
+#define SERIAL_LAZY_BEGIN()
+
+#endif
+
+#endif
@@ -20,6 +20,27 @@
 
 #include "Arduino.h"
 
+//----------------------------------------------------------------------------
+// _sdcc_external_startup()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      0, so the startup code goes on to initialize the C runtime
+//
+// Remarks:
+//      called by the startup code right after reset, before __data and
+//      __xdata are set up. It only touches SFRs, to start the boot timer.
+//----------------------------------------------------------------------------
+
+unsigned char _sdcc_external_startup (void)
+{
+    BOOT_TIMER_START();
+    
+    return 0;
+} // End of _sdcc_external_startup()
+
 //----------------------------------------------------------------------------
 // main()
 //
@@ -35,9 +56,19 @@
  
 void main()
 {          
+    boot_mark_main();
+    
+#if !defined(FAST_BOOT) || defined(STACK_CHECK)
+    stack_paint();
+#endif
+    
    // ECODEC = 1;
     
-    Serial.begin(921600);
+#ifndef FAST_BOOT
+    Serial.begin(SERIAL_DEFAULT_BAUD_RATE);
+#endif
+    
+    chip_id_begin();
     
  //   __asm__ ("nop");
  //   __asm__ ("nop");
@@ -45,6 +76,8 @@ void main()
  //   __asm__ ("nop");
     
     //delay (1000);
+    boot_mark_setup();
+    
     setup();
     
     while (1) {
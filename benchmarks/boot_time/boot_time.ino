@@ -0,0 +1,57 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// Boot time
+//
+// Prints the cycles from the first instruction to setup(), as measured by
+// the core (see boot.h). Build it with Tools > Boot set to Normal and to
+// Fast to compare, and with Tools > Noinit XRAM on to move the 1 KB
+// buffer below from the cleared __xdata into the noinit window.
+//============================================================================================
+
+#define BOOT_BENCH_BUFFER_SIZE 1024
+
+#ifdef NOINIT
+static __noinit (0) uint8_t buffer [BOOT_BENCH_BUFFER_SIZE];
+#else
+static __xdata uint8_t buffer [BOOT_BENCH_BUFFER_SIZE];
+#endif
+
+void setup()
+{
+    uint32_t cycles = boot_cycles ();
+
+    // keep the buffer in the link
+    buffer[0] = (uint8_t)cycles;
+
+    Serial.write ("boot cycles: ");
+    Serial.println (cycles);
+    Serial.write ("boot us:     ");
+    Serial.println (cycles / BOOT_CYCLES_PER_US);
+    Serial.write ("cold boot:   ");
+    Serial.println (boot_cold ());
+    Serial.write ("resets:      ");
+    Serial.println (boot_count ());
+}
+
+void loop()
+{
+}
@@ -0,0 +1,155 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// DSP kernel benchmark
+//
+// Timer 0 (mode 1, set up by Serial.begin()) counts CPU clocks; its
+// overflows are counted in the TIMER0 handler to extend it to 32 bits.
+// Results are printed as cycles per block and cycles per sample.
+//============================================================================================
+
+#define BENCH_BLOCK_SIZE 32
+#define BENCH_FIR_TAPS   16
+
+static __code q15_t fir_coefficients [BENCH_FIR_TAPS] = {
+    -218, -306, -234, 245, 1180, 2448, 3743, 4631,
+    4631, 3743, 2448, 1180, 245, -234, -306, -218
+};
+
+// 2 stage lowpass, {b0, b1, b2, -a1, -a2}, Q14
+static __code q15_t biquad_coefficients [10] = {
+    1067, 2134, 1067, 24380, -12264,
+    1067, 2134, 1067, 27066, -14951
+};
+
+static __xdata q15_t fir_delay [BENCH_FIR_TAPS * 2];
+static __xdata q15_t biquad_state [10];
+static __xdata DSP_COMPLEX_Q15 fft_data [1 << DSP_FFT_MAX_LOG2_SIZE];
+
+static q15_t samples [BENCH_BLOCK_SIZE];
+
+static DSP_FIR_Q15 fir;
+static DSP_BIQUAD_Q14 biquad;
+static DSP_GOERTZEL_Q14 goertzel;
+
+static volatile uint16_t timer0_overflow_count;
+
+static void timer0_overflow ()
+{
+    ++timer0_overflow_count;
+}
+
+static void cycle_start ()
+{
+    TR0 = 0;
+    TH0 = 0;
+    TL0 = 0;
+    TF0 = 0;
+    timer0_overflow_count = 0;
+    TR0 = 1;
+}
+
+static uint32_t cycle_stop ()
+{
+    uint32_t cycles;
+
+    TR0 = 0;
+
+    // a pending overflow is taken before this point
+    cycles = ((uint32_t)TH0 << 8) | TL0;
+    cycles |= (uint32_t)timer0_overflow_count << 16;
+
+    return cycles;
+}
+
+static void report (uint8_t* name, uint32_t cycles, uint16_t samples_per_block)
+{
+    Serial.write (name);
+    Serial.write (" cycles/block = ");
+    Serial.print (cycles);
+    Serial.write (", cycles/sample = ");
+    Serial.println (cycles / samples_per_block);
+}
+
+static void fill_samples ()
+{
+    uint8_t i;
+
+    for (i = 0; i < BENCH_BLOCK_SIZE; ++i) {
+        samples[i] = (i & 4) ? 12000 : -12000;
+    }
+}
+
+void setup()
+{
+    attachIsrHandler (TIMER0_INT_INDEX, timer0_overflow);
+    ET0 = 1;
+
+    dsp_fir_init (&fir, fir_coefficients, fir_delay, BENCH_FIR_TAPS);
+    dsp_biquad_init (&biquad, biquad_coefficients, biquad_state, 2);
+    dsp_goertzel_init (&goertzel, 27246, 2);
+}
+
+void loop()
+{
+    uint8_t log2_size;
+    uint16_t i, size;
+    uint32_t cycles;
+
+    Serial.println (0);
+
+    fill_samples ();
+    cycle_start ();
+    dsp_fir (&fir, samples, samples, BENCH_BLOCK_SIZE);
+    report ("fir16", cycle_stop (), BENCH_BLOCK_SIZE);
+
+    fill_samples ();
+    cycle_start ();
+    dsp_biquad (&biquad, samples, samples, BENCH_BLOCK_SIZE);
+    report ("biquad2", cycle_stop (), BENCH_BLOCK_SIZE);
+
+    fill_samples ();
+    cycle_start ();
+    dsp_goertzel (&goertzel, samples, BENCH_BLOCK_SIZE);
+    cycles = cycle_stop ();
+    dsp_goertzel_power (&goertzel);
+    report ("goertzel", cycles, BENCH_BLOCK_SIZE);
+
+    for (log2_size = 4; log2_size <= DSP_FFT_MAX_LOG2_SIZE; ++log2_size) {
+        size = (uint16_t)1 << log2_size;
+
+        for (i = 0; i < size; ++i) {
+            fft_data[i].re = (i & 4) ? 12000 : -12000;
+            fft_data[i].im = 0;
+        }
+
+        cycle_start ();
+        dsp_fft (fft_data, log2_size);
+        cycles = cycle_stop ();
+
+        Serial.write ("fft");
+        Serial.print (size);
+        Serial.write (" cycles = ");
+        Serial.println (cycles);
+    }
+
+    delay (2000);
+}
@@ -0,0 +1,196 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// Optimization profile benchmark
+//
+// Plain C kernels of the kind sketches are made of (bit loops, array
+// walks, 32 bit arithmetic, nested loops), to compare the "Optimization"
+// menu profiles. Build and run it once per profile, and compare the cycle
+// counts, and the code size with tools/core_size.py (see README.md).
+//
+// Timer 0 (mode 1, set up by Serial.begin()) counts CPU clocks; its
+// overflows are counted in the TIMER0 handler to extend it to 32 bits.
+//============================================================================================
+
+#define BENCH_DATA_SIZE 128
+#define BENCH_SORT_SIZE 32
+
+static __xdata uint8_t data_bytes [BENCH_DATA_SIZE];
+static __xdata int16_t data_words [BENCH_DATA_SIZE];
+static __xdata int16_t sort_words [BENCH_SORT_SIZE];
+
+static volatile uint16_t timer0_overflow_count;
+
+static void timer0_overflow ()
+{
+    ++timer0_overflow_count;
+}
+
+static void cycle_start ()
+{
+    TR0 = 0;
+    TH0 = 0;
+    TL0 = 0;
+    TF0 = 0;
+    timer0_overflow_count = 0;
+    TR0 = 1;
+}
+
+static uint32_t cycle_stop ()
+{
+    uint32_t cycles;
+
+    TR0 = 0;
+
+    // a pending overflow is taken before this point
+    cycles = ((uint32_t)TH0 << 8) | TL0;
+    cycles |= (uint32_t)timer0_overflow_count << 16;
+
+    return cycles;
+}
+
+static void report (uint8_t* name, uint32_t cycles, uint32_t result)
+{
+    Serial.write (name);
+    Serial.write (" cycles = ");
+    Serial.print (cycles);
+    Serial.write (", result = ");
+    Serial.println (result);
+}
+
+// CRC-16/CCITT, bit by bit
+static uint16_t crc16_bitwise (__xdata uint8_t* buf, uint8_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t i, j;
+
+    for (i = 0; i < length; ++i) {
+        crc ^= (uint16_t)buf[i] << 8;
+        for (j = 0; j < 8; ++j) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ 0x1021;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+// sum of squares, 16 x 16 -> 32 bit
+static int32_t sum_of_squares (__xdata int16_t* buf, uint8_t length)
+{
+    int32_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < length; ++i) {
+        sum += (int32_t)buf[i] * buf[i];
+    }
+
+    return sum;
+}
+
+// insertion sort
+static void sort (__xdata int16_t* buf, uint8_t length)
+{
+    uint8_t i, j;
+    int16_t t;
+
+    for (i = 1; i < length; ++i) {
+        t = buf[i];
+        for (j = i; (j > 0) && (buf[j - 1] > t); --j) {
+            buf[j] = buf[j - 1];
+        }
+        buf[j] = t;
+    }
+}
+
+// 32 bit integer square root, bit by bit
+static uint16_t isqrt32 (uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+
+    while (bit) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)root;
+}
+
+void setup()
+{
+    uint8_t i;
+
+    attachIsrHandler (TIMER0_INT_INDEX, timer0_overflow);
+    ET0 = 1;
+
+    for (i = 0; i < BENCH_DATA_SIZE; ++i) {
+        data_bytes[i] = i * 37 + 11;
+        data_words[i] = (int16_t)(i * 517) - 30000;
+    }
+}
+
+void loop()
+{
+    uint8_t i;
+    uint32_t cycles;
+    uint32_t result;
+
+    Serial.println (0);
+
+    cycle_start ();
+    result = crc16_bitwise (data_bytes, BENCH_DATA_SIZE);
+    report ("crc16", cycle_stop (), result);
+
+    cycle_start ();
+    result = sum_of_squares (data_words, BENCH_DATA_SIZE);
+    report ("sum_of_squares", cycle_stop (), result);
+
+    for (i = 0; i < BENCH_SORT_SIZE; ++i) {
+        sort_words[i] = data_words[(i * 13) & (BENCH_DATA_SIZE - 1)];
+    }
+
+    cycle_start ();
+    sort (sort_words, BENCH_SORT_SIZE);
+    cycles = cycle_stop ();
+    report ("sort", cycles, sort_words[0]);
+
+    cycle_start ();
+    result = 0;
+    for (i = 0; i < 16; ++i) {
+        result += isqrt32 ((uint32_t)i * 123456789UL);
+    }
+    report ("isqrt32 x16", cycle_stop (), result);
+
+    delay (2000);
+}
@@ -0,0 +1,71 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// Telemetry throughput
+//
+// Sends the same block of 16 bit samples (a ramp) once as decimal text
+// (one per line) and once as TELEMETRY_TYPE_U16 records, and prints the
+// samples per second of both. Capture the output with tools/telemetry_decode.py to check the
+// binary part; the text lines just show up as bad frames there.
+//============================================================================================
+
+#define BENCH_NUM_OF_SAMPLES 2048
+#define BENCH_BLOCK_SIZE     (TELEMETRY_MAX_PAYLOAD / 2)
+
+static __xdata uint16_t samples [BENCH_BLOCK_SIZE];
+
+void setup()
+{
+    uint16_t i;
+    uint16_t n;
+    uint32_t start;
+    uint32_t ascii_ms;
+    uint32_t binary_ms;
+
+    for (i = 0; i < BENCH_BLOCK_SIZE; ++i) {
+        samples[i] = i * 37;
+    }
+
+    start = millis ();
+    for (i = 0; i < BENCH_NUM_OF_SAMPLES; ++i) {
+        Serial.println (samples[i % BENCH_BLOCK_SIZE]);
+    }
+    ascii_ms = millis () - start;
+
+    start = millis ();
+    for (i = 0; i < BENCH_NUM_OF_SAMPLES; i += n) {
+        n = BENCH_NUM_OF_SAMPLES - i;
+        if (n > BENCH_BLOCK_SIZE) {
+            n = BENCH_BLOCK_SIZE;
+        }
+        telemetry_send (TELEMETRY_TYPE_U16, (uint8_t*)samples, (uint8_t)(n * 2));
+    }
+    binary_ms = millis () - start;
+
+    Serial.write ("\r\ntext samples/s = ");
+    Serial.println (BENCH_NUM_OF_SAMPLES * 1000UL / ascii_ms);
+    Serial.write ("binary samples/s = ");
+    Serial.println (BENCH_NUM_OF_SAMPLES * 1000UL / binary_ms);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,611 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "cache.h"
+#include "hash.h"
+#include "file_util.h"
+#include "process.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+// files sdcc writes next to the .rel
+static const char* cache_output_suffixes[] = {".rel", ".asm", ".lst", ".sym", ".adb"};
+
+#define CACHE_HIT_LOG  "hits.log"
+#define CACHE_MISS_LOG "misses.log"
+#define CACHE_STDOUT   "stdout"
+#define CACHE_STDERR   "stderr"
+
+// size cap when M10_CACHE_MAX_MB is not set
+#define CACHE_MAX_MB_DEFAULT 512
+
+// a prune reads the whole cache, so a store only starts one every so often
+#define CACHE_PRUNE_INTERVAL 32
+
+typedef struct {
+    std::string path;
+    int64_t last_used;
+    int64_t size;
+} CACHE_ENTRY;
+
+//----------------------------------------------------------------------------
+// cache_dir()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the cache directory
+//
+// Remarks:
+//      function to locate the cache, see cache.h
+//----------------------------------------------------------------------------
+
+std::string cache_dir ()
+{
+    const char* env = getenv ("M10_CACHE_DIR");
+    
+    if (env && env[0]) {
+        return env;
+    }
+    
+#ifdef _WIN32
+    env = getenv ("LOCALAPPDATA");
+    
+    if (env && env[0]) {
+        return path_join (env, "M10_compiler_cache");
+    }
+#else
+    env = getenv ("XDG_CACHE_HOME");
+    
+    if (env && env[0]) {
+        return path_join (env, "m10_compiler");
+    }
+    
+    env = getenv ("HOME");
+    
+    if (env && env[0]) {
+        return path_join (env, ".cache/m10_compiler");
+    }
+#endif
+
+    return "";
+    
+} // End of cache_dir()
+
+
+//----------------------------------------------------------------------------
+// cache_enabled()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      true unless M10_CACHE_DISABLE is set, or there is no place for the
+//      cache
+//
+// Remarks:
+//      function to check whether compiles go through the cache
+//----------------------------------------------------------------------------
+
+bool cache_enabled ()
+{
+    const char* env = getenv ("M10_CACHE_DISABLE");
+    
+    if (env && env[0] && strcmp (env, "0")) {
+        return false;
+    }
+    
+    return !cache_dir().empty();
+    
+} // End of cache_enabled()
+
+
+//----------------------------------------------------------------------------
+// replay()
+//
+// Parameters:
+//      path : captured output
+//      f    : stdout or stderr
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to pass captured tool output on to the IDE
+//----------------------------------------------------------------------------
+
+static void replay (const std::string& path, FILE* f)
+{
+    std::string content;
+    
+    if (file_read (path, content) && content.size()) {
+        fwrite (content.data(), 1, content.size(), f);
+        fflush (f);
+    }
+    
+} // End of replay()
+
+
+//----------------------------------------------------------------------------
+// sdcc_version()
+//
+// Parameters:
+//      sdcc : the sdcc binary
+//      dir  : cache directory
+//
+// Return Value:
+//      output of sdcc --version, "" if it can not be run
+//
+// Remarks:
+//      function to get the compiler version. It is remembered in the cache
+//      by the size and time stamp of the binary, so sdcc --version only
+//      runs again when sdcc changes.
+//----------------------------------------------------------------------------
+
+static std::string sdcc_version (const std::string& sdcc, const std::string& dir)
+{
+    std::string stamp = file_stamp (sdcc);
+    std::string memo;
+    std::string version;
+    std::string tmp;
+    std::vector<std::string> args;
+    Sha256 hash;
+    
+    if (stamp.size()) {
+        hash.update_field (sdcc);
+        hash.update_field (stamp);
+        memo = path_join (dir, "sdcc_" + hash.hex_digest().substr (0, 16) + ".version");
+        
+        if (file_read (memo, version) && version.size()) {
+            return version;
+        }
+    }
+    
+    tmp = temp_name (dir, ".version");
+    args.push_back ("--version");
+    
+    if (process_run (sdcc, args, tmp) == 0) {
+        file_read (tmp, version);
+    }
+    
+    remove (tmp.c_str());
+    
+    if (memo.size() && version.size()) {
+        file_write (memo, version);
+    }
+    
+    return version;
+    
+} // End of sdcc_version()
+
+
+//----------------------------------------------------------------------------
+// cache_max_bytes()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the size cap in bytes, 0 for no cap
+//
+// Remarks:
+//      M10_CACHE_MAX_MB sets the cap in MB, 0 turns it off
+//----------------------------------------------------------------------------
+
+static int64_t cache_max_bytes ()
+{
+    const char* env = getenv ("M10_CACHE_MAX_MB");
+    int64_t mb = CACHE_MAX_MB_DEFAULT;
+    
+    if (env && env[0]) {
+        mb = atoll (env);
+    }
+    
+    return ((mb > 0) ? (mb * 1024 * 1024) : 0);
+    
+} // End of cache_max_bytes()
+
+
+//----------------------------------------------------------------------------
+// cache_entries()
+//
+// Parameters:
+//      dir     : the cache directory
+//      entries : receives every stored compile, with its size and the
+//                time of its last use
+//
+// Return Value:
+//      total size of the entries, in bytes
+//
+// Remarks:
+//      function to walk the <2 hex digits>/<key> directories of the cache
+//----------------------------------------------------------------------------
+
+static int64_t cache_entries (const std::string& dir, std::vector<CACHE_ENTRY>& entries)
+{
+    std::vector<std::string> prefixes;
+    std::vector<std::string> keys;
+    std::vector<std::string> files;
+    CACHE_ENTRY e;
+    int64_t total = 0;
+    int64_t n;
+    size_t i, j, k;
+    
+    entries.clear();
+    dir_list (dir, prefixes);
+    
+    for (i = 0; i < prefixes.size(); ++i) {
+        // tmp/ and main/ are not entries
+        if ((prefixes[i].size() != 2) || !isxdigit ((unsigned char)prefixes[i][0]) || 
+            !isxdigit ((unsigned char)prefixes[i][1])) {
+            continue;
+        }
+        
+        dir_list (path_join (dir, prefixes[i]), keys);
+        
+        for (j = 0; j < keys.size(); ++j) {
+            e.path = path_join (path_join (dir, prefixes[i]), keys[j]);
+            e.last_used = file_mtime (path_join (e.path, "rel"));
+            e.size = 0;
+            
+            dir_list (e.path, files);
+            
+            for (k = 0; k < files.size(); ++k) {
+                n = file_size (path_join (e.path, files[k]));
+                if (n > 0) {
+                    e.size += n;
+                }
+            } // End of for loop
+            
+            total += e.size;
+            entries.push_back (e);
+        } // End of for loop
+    } // End of for loop
+    
+    return total;
+    
+} // End of cache_entries()
+
+
+//----------------------------------------------------------------------------
+// cache_prune()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to remove the least recently used entries while the cache
+//      is over its cap. It goes down to 3/4 of the cap, so that the next
+//      stores do not start another prune right away.
+//----------------------------------------------------------------------------
+
+void cache_prune ()
+{
+    std::string dir = cache_dir ();
+    std::vector<CACHE_ENTRY> entries;
+    int64_t max_bytes = cache_max_bytes ();
+    int64_t total;
+    size_t i;
+    
+    if (dir.empty() || (max_bytes == 0)) {
+        return;
+    }
+    
+    total = cache_entries (dir, entries);
+    
+    if (total <= max_bytes) {
+        return;
+    }
+    
+    std::sort (entries.begin(), entries.end(), 
+               [](const CACHE_ENTRY& a, const CACHE_ENTRY& b) { return (a.last_used < b.last_used); });
+    
+    for (i = 0; (i < entries.size()) && (total > (max_bytes / 4 * 3)); ++i) {
+        dir_remove (entries[i].path);
+        total -= entries[i].size;
+    } // End of for loop
+    
+} // End of cache_prune()
+
+
+//----------------------------------------------------------------------------
+// cache_compile()
+//
+// Parameters:
+//      sdcc : the sdcc binary
+//      args : sdcc arguments for a compile (-c ... -o xxx.rel)
+//
+// Return Value:
+//      exit code of the compile, from sdcc or from the cache
+//
+// Remarks:
+//      function to compile through the cache, see cache.h
+//----------------------------------------------------------------------------
+
+int cache_compile (const std::string& sdcc, const std::vector<std::string>& args)
+{
+    std::string dir = cache_dir ();
+    std::string output;
+    std::string base;
+    std::string version;
+    std::string preprocessed;
+    std::string key;
+    std::string entry;
+    std::string staging;
+    std::string out_log;
+    std::string err_log;
+    std::vector<std::string> pp_args;
+    Sha256 hash;
+    size_t i;
+    int rc;
+    
+    for (i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "-o") {
+            output = args[i + 1];
+        }
+    } // End of for loop
+    
+    if ((!cache_enabled ()) || (output.size() < 4) || 
+        (output.compare (output.size() - 4, 4, ".rel") != 0) || (!dir_make (path_join (dir, "tmp")))) {
+        return process_run (sdcc, args);
+    }
+    
+    base = output.substr (0, output.size() - 4);
+    
+    //== hash the version, the arguments and the preprocessed source
+    version = sdcc_version (sdcc, dir);
+    
+    for (i = 0; i < args.size(); ++i) {
+        if (args[i] == "-o") {
+            ++i;
+        } else if ((args[i] != "-c") && (args[i] != "-V")) {
+            pp_args.push_back (args[i]);
+        }
+    } // End of for loop
+    
+    pp_args.push_back ("-E");
+    
+    preprocessed = temp_name (path_join (dir, "tmp"), ".i");
+    
+    if (version.empty() || (process_run (sdcc, pp_args, preprocessed) != 0)) {
+        remove (preprocessed.c_str());
+        return process_run (sdcc, args);
+    }
+    
+    hash.update_field (CACHE_VERSION);
+    hash.update_field (version);
+    
+    for (i = 0; i < args.size(); ++i) {
+        hash.update_field (args[i]);
+        
+        // where the output goes does not change it, the peephole rules do
+        if (args[i] == "-o") {
+            ++i;
+        } else if ((args[i] == "--peep-file") && ((i + 1) < args.size())) {
+            hash_file (hash, args[i + 1]);
+        }
+    } // End of for loop
+    
+    hash_file (hash, preprocessed);
+    remove (preprocessed.c_str());
+    
+    key = hash.hex_digest ();
+    entry = path_join (path_join (dir, key.substr (0, 2)), key);
+    
+    //== hit
+    if (path_exists (path_join (entry, "rel"))) {
+        for (i = 0; i < sizeof(cache_output_suffixes) / sizeof(cache_output_suffixes[0]); ++i) {
+            std::string from = path_join (entry, cache_output_suffixes[i] + 1);
+            
+            if (path_exists (from)) {
+                file_copy (from, base + cache_output_suffixes[i]);
+            }
+        } // End of for loop
+        
+        replay (path_join (entry, CACHE_STDOUT), stdout);
+        replay (path_join (entry, CACHE_STDERR), stderr);
+        
+        // the rel's time is the last use, see cache_prune()
+        file_touch (path_join (entry, "rel"));
+        
+        file_append (path_join (dir, CACHE_HIT_LOG), "H");
+        
+        return 0;
+    }
+    
+    //== miss, compile and store
+    staging = temp_name (path_join (dir, "tmp"), "");
+    dir_make (staging);
+    
+    out_log = path_join (staging, CACHE_STDOUT);
+    err_log = path_join (staging, CACHE_STDERR);
+    
+    rc = process_run (sdcc, args, out_log, err_log);
+    
+    replay (out_log, stdout);
+    replay (err_log, stderr);
+    
+    file_append (path_join (dir, CACHE_MISS_LOG), "M");
+    
+    if (rc == 0) {
+        for (i = 0; i < sizeof(cache_output_suffixes) / sizeof(cache_output_suffixes[0]); ++i) {
+            std::string from = base + cache_output_suffixes[i];
+            
+            if (path_exists (from)) {
+                file_copy (from, path_join (staging, cache_output_suffixes[i] + 1));
+            }
+        } // End of for loop
+        
+        dir_make (path_join (dir, key.substr (0, 2)));
+        
+        // another build may have stored the same entry meanwhile
+        if (file_rename (staging, entry)) {
+            if ((file_size (path_join (dir, CACHE_MISS_LOG)) % CACHE_PRUNE_INTERVAL) == 0) {
+                cache_prune ();
+            }
+            
+            return rc;
+        }
+    }
+    
+    dir_remove (staging);
+    
+    return rc;
+    
+} // End of cache_compile()
+
+
+//----------------------------------------------------------------------------
+// cache_core_main()
+//
+// Parameters:
+//      sdcc   : the sdcc binary
+//      main_c : the core main.c
+//      flags  : sdcc options and preprocessor flags (-D / -U / -I) of the
+//               link
+//
+// Return Value:
+//      path of main.rel for these flags, "" if the cache is off or main.c
+//      does not compile (the link then compiles main.c itself, and
+//      reports the errors)
+//
+// Remarks:
+//      function to compile main.c once per flag set. Each flag set gets
+//      its own directory, and cache_compile() checks the preprocessed
+//      source, so a change in main.c or in the core headers is still
+//      picked up.
+//----------------------------------------------------------------------------
+
+std::string cache_core_main (const std::string& sdcc, const std::string& main_c, 
+                             const std::vector<std::string>& flags)
+{
+    std::string out_dir;
+    std::string output;
+    std::vector<std::string> args;
+    Sha256 hash;
+    size_t i;
+    
+    if (!cache_enabled ()) {
+        return "";
+    }
+    
+    hash.update_field (CACHE_VERSION);
+    hash.update_field (main_c);
+    
+    for (i = 0; i < flags.size(); ++i) {
+        hash.update_field (flags[i]);
+    } // End of for loop
+    
+    out_dir = path_join (path_join (cache_dir (), "main"), hash.hex_digest().substr (0, 16));
+    
+    if (!dir_make (out_dir)) {
+        return "";
+    }
+    
+    output = path_join (out_dir, "main.rel");
+    
+    args = flags;
+    args.push_back ("-c");
+    args.push_back (main_c);
+    args.push_back ("-o");
+    args.push_back (output);
+    
+    if (cache_compile (sdcc, args) != 0) {
+        return "";
+    }
+    
+    return output;
+    
+} // End of cache_core_main()
+
+
+//----------------------------------------------------------------------------
+// cache_print_stats()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to print the hit / miss counts (the size of the two logs,
+//      one byte per compile), and the size of the cache
+//----------------------------------------------------------------------------
+
+void cache_print_stats ()
+{
+    std::string dir = cache_dir ();
+    std::vector<CACHE_ENTRY> entries;
+    int64_t hits = file_size (path_join (dir, CACHE_HIT_LOG));
+    int64_t misses = file_size (path_join (dir, CACHE_MISS_LOG));
+    int64_t total = cache_entries (dir, entries);
+    int64_t max_bytes = cache_max_bytes ();
+    
+    if (hits < 0) {
+        hits = 0;
+    }
+    
+    if (misses < 0) {
+        misses = 0;
+    }
+    
+    printf ("cache directory : %s%s\n", dir.c_str(), cache_enabled () ? "" : " (disabled)");
+    printf ("hits            : %lld\n", (long long)hits);
+    printf ("misses          : %lld\n", (long long)misses);
+    printf ("hit rate        : %.1f %%\n", (hits + misses) ? (100.0 * hits / (hits + misses)) : 0.0);
+    printf ("entries         : %u, %.1f MB", (unsigned)entries.size(), total / (1024.0 * 1024.0));
+    
+    if (max_bytes) {
+        printf (" of %.0f MB\n", max_bytes / (1024.0 * 1024.0));
+    } else {
+        printf (", no cap\n");
+    }
+    
+} // End of cache_print_stats()
+
+
+//----------------------------------------------------------------------------
+// cache_clear()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to remove all cache entries and reset the statistics
+//----------------------------------------------------------------------------
+
+void cache_clear ()
+{
+    std::string dir = cache_dir ();
+    
+    if (dir.size()) {
+        dir_remove (dir);
+    }
+    
+} // End of cache_clear()
@@ -0,0 +1,63 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <string>
+#include <vector>
+
+//============================================================================================
+// Compilation cache
+//
+// An sdcc compile is looked up by the SHA-256 of
+//      - the sdcc version (sdcc --version, remembered per sdcc binary)
+//      - the full sdcc argument list, except the name after -o
+//      - the peephole rules given with --peep-file
+//      - the source after preprocessing (sdcc -E), so headers count too
+// On a hit, the .rel / .asm / .lst / .sym (and .adb, if any) and the
+// messages of the original compile are put back, and sdcc does not run.
+// Only successful compiles are stored.
+//
+// The core main.c, which used to be compiled again on every link, is
+// compiled through the cache as well, into one main.rel per flag set
+// under main/ in the cache, and the link takes that object instead.
+//
+// The cache lives in M10_CACHE_DIR if set, otherwise in
+// %LOCALAPPDATA%\M10_compiler_cache (Windows) or ~/.cache/m10_compiler.
+// Set M10_CACHE_DISABLE=1 to bypass it.
+//
+// The entries are capped at M10_CACHE_MAX_MB (512 MB by default, 0 for no
+// cap). A hit marks its entry as used, and every so often a store prunes
+// the least recently used entries, see cache_prune(). The main.rel
+// objects are a handful per flag set and are not counted.
+//============================================================================================
+
+#define CACHE_VERSION "m10-cache-1"
+
+extern std::string cache_dir ();
+extern bool cache_enabled ();
+
+extern int cache_compile (const std::string& sdcc, const std::vector<std::string>& args);
+extern std::string cache_core_main (const std::string& sdcc, const std::string& main_c, 
+                                    const std::vector<std::string>& flags);
+
+extern void cache_print_stats ();
+extern void cache_prune ();
+extern void cache_clear ();
+
+#endif
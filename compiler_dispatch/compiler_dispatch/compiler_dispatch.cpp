@@ -1,160 +1,552 @@
-#include <iostream>
-#include <string>
-
-constexpr std::size_t MAX_PATH_LENGTH = 8192;
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// compiler_dispatch
+//
+// The Arduino IDE drives the build with avr-gcc style command lines (see
+// platform.txt). This program sits in their place and
+//      - hands preprocessing (-E, used by the IDE to scan for includes and
+//        to build the sketch prototypes) to avr-g++ unchanged
+//      - turns compiling (-c) into an sdcc compile with the FP51 options
+//      - turns the final link into an sdcc link, adding the core main.c
+//        (as a main.rel compiled once per flag set, when the cache is on)
+// .o / .a / .elf names become .rel / .lib / .ihx on the way, and the avr
+// only options (-mprocessor, -T, -lm, cpp-startup.S) are dropped.
+//
+// With --m10-unity (the "Build" menu), the sketch is built as one
+// translation unit instead, see unity.h.
+//
+// --m10-opt=<profile> (the "Optimization" menu) picks the sdcc optimizer
+// options, see opt_profiles[]. Without it, the legacy profile is used.
+//
+// --m10-model=<model> (no menu yet, see README.md) picks the memory model,
+// its internal RAM and stack options, and the matching library set under
+// SDCC/lib, see memory_models[]. Without it, large-xstack is used.
+//
+// --m10-stack=<address> (no menu yet either) moves the hardware stack away
+// from the default of the memory model. The address also goes to the core
+// as STACK_IDATA_LOCATION, for stack.h.
+//
+// With --m10-overlay (no menu yet, see README.md), sketch and library
+// sources are compiled without --nooverlay, and the link compiles again with
+// it the ones whose overlaid locals an ISR can reach, see overlay.h. Only
+// the small model has locals to overlay, it is ignored in the others.
+//
+// With --m10-layout (no menu yet, see README.md), the link places the sketch
+// and library code in 2 KB pages so that calls can be acall / ajmp, see
+// layout.h.
+//
+// Compiles go through the cache (see cache.h), and
+//      compiler_dispatch --cache-stats
+//      compiler_dispatch --cache-prune
+//      compiler_dispatch --cache-clear
+// print the hit / miss counts, trim the cache to its cap, or empty it.
+//============================================================================================
 
-bool string_start_with(std::string str_in, std::string str_match)
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include "process.h"
+#include "cache.h"
+#include "unity.h"
+#include "overlay.h"
+#include "layout.h"
+
+#define SDCC_TOOL       "sdcc"
+#define SDAS_TOOL       "sdas8051"
+#define AVR_GXX_TOOL    "../../avr/bin/avr-g++"
+#define CORE_MAIN_C     "../core/main.c"
+
+#define OPT_OPTION      "--m10-opt="
+#define OPT_DEFAULT     "legacy"
+
+#define MODEL_OPTION    "--m10-model="
+#define MODEL_DEFAULT   "large-xstack"
+
+#define STACK_OPTION    "--m10-stack="
+#define SDCC_LIB_DIR    "../lib"
+
+// --nooverlay in all profiles: the ISR handlers call into the core, and
+// overlaid locals of non-reentrant functions are not safe for that. The
+// RAM overlay option takes it out where overlay.cpp finds it safe.
+static const char* sdcc_options[] = {
+    "--disable-warning", "151", "-V", "--nooverlay", "--std-c11"
+};
+
+#define MODEL_MAX_OPTIONS 4
+
+typedef struct {
+    const char* name;                       // also the library set under SDCC/lib
+    const char* options[MODEL_MAX_OPTIONS];
+    const char* iram_size;                  // --iram-size
+    const char* stack_loc;                  // --stack-loc, unless --m10-stack= is given
+    bool overlay;                           // locals in internal RAM, see --m10-overlay
+} MEMORY_MODEL;
+
+// The hardware stack grows up from --stack-loc with the 16 bit SP, past
+// 0xFF. In the large and medium models only the explicit __data variables
+// are in DSEG, and the stack starts at 0x7E as it always did. In the small
+// models every variable is in DSEG, so the stack goes above the direct
+// RAM (0x80) and DSEG gets all of 0x08 ~ 0x7F.
+//
+// sdcc only overlays the locals of non-reentrant functions, when they are
+// in internal RAM. So --m10-overlay does something in the small model only,
+// and is ignored in the others (with --stack-auto, locals are on the stack).
+static const MEMORY_MODEL memory_models[] = {
+    // variables in XRAM, reentrant locals and parameters on the xstack
+    {"large-xstack",     {"--model-large", "--xstack"},       "128", "126", false},
+    
+    // variables in XRAM, reentrant locals on the hardware stack
+    {"large",            {"--model-large"},                   "128", "126", false},
+    
+    // variables in one 256 byte page of XRAM, reached with movx @ri
+    {"medium",           {"--model-medium"},                  "128", "126", false},
+    
+    // variables in internal RAM
+    {"small",            {"--model-small"},                   "256", "128", true},
+    
+    // variables in internal RAM, every function reentrant
+    {"small-stack-auto", {"--model-small", "--stack-auto"},   "256", "128", false}
+};
+
+// below this, the stack shares the direct RAM with DSEG
+#define STACK_DIRECT_RAM_END 128
+
+#define OPT_MAX_OPTIONS 8
+
+typedef struct {
+    const char* name;
+    const char* options[OPT_MAX_OPTIONS];
+} OPT_PROFILE;
+
+static const OPT_PROFILE opt_profiles[] = {
+    // the options the package always had
+    {"legacy", {"--nogcse", "--noinduction"}},
+    
+    // all optimizations on, favor speed / size where sdcc has a choice
+    {"speed",  {"--opt-code-speed"}},
+    {"size",   {"--opt-code-size"}},
+    
+    // code that follows the source, for sdcdb and for reading the .asm
+    {"debug",  {"--debug", "--no-peep", "--nogcse", "--noinduction", "--noinvariant", 
+                "--noloopreverse", "--nolabelopt"}}
+};
+
+typedef struct {
+    const char* from;
+    const char* to;
+} SUFFIX_MAP;
+
+static const SUFFIX_MAP suffix_map[] = {
+    {".o",   ".rel"},
+    {".a",   ".lib"},
+    {".elf", ".ihx"}
+};
+
+//----------------------------------------------------------------------------
+// string_end_with()
+//
+// Parameters:
+//      s      : string to check
+//      suffix : suffix to look for
+//
+// Return Value:
+//      true if s ends with suffix
+//
+// Remarks:
+//      helper for the file name translation
+//----------------------------------------------------------------------------
+
+static bool string_end_with (const std::string& s, const char* suffix)
 {
-	if (str_in.length() < str_match.length()) {
-		return false;
-	}
-	else {
-		return (0 == str_in.compare(0, str_match.length(), str_match));
-	}
-}
-
-bool string_end_with(std::string str_in, std::string str_match)
+    size_t n = strlen (suffix);
+    
+    return ((s.size() >= n) && (s.compare (s.size() - n, n, suffix) == 0));
+    
+} // End of string_end_with()
+
+
+//----------------------------------------------------------------------------
+// string_start_with()
+//
+// Parameters:
+//      s      : string to check
+//      prefix : prefix to look for
+//
+// Return Value:
+//      true if s starts with prefix
+//
+// Remarks:
+//      helper for the option filter
+//----------------------------------------------------------------------------
+
+static bool string_start_with (const std::string& s, const char* prefix)
 {
-	if (str_in.length() < str_match.length()) {
-		return false;
-	} else {
-		return (0 == str_in.compare(str_in.length() - str_match.length(), str_match.length(), str_match));
-	}
-}
-
-std::string tail_replace(std::string str_in)
+    return (s.compare (0, strlen (prefix), prefix) == 0);
+    
+} // End of string_start_with()
+
+
+//----------------------------------------------------------------------------
+// option_filter()
+//
+// Parameters:
+//      arg  : one argument from the IDE
+//      keep : set to false if the argument is to be dropped
+//
+// Return Value:
+//      the argument for sdcc
+//
+// Remarks:
+//      function to translate one avr-gcc argument for sdcc
+//----------------------------------------------------------------------------
+
+static std::string option_filter (const std::string& arg, bool& keep)
 {
-	std::string str_obj{ ".o" };
-	std::string str_obj_quotation{ ".o\"" };
-
-	std::string str_lib{ ".a" };
-	std::string str_lib_quotation{ ".a\"" };
-
-	std::string str_elf{ ".elf" };
-	std::string str_elf_quotation{ ".elf\"" };
-
-
-	std::string str_ret{str_in};
-
-	if (string_end_with(str_in, str_obj)) {
-		str_ret = str_in.substr(0, str_in.length() - str_obj.length()) + ".rel";
-	} else if (string_end_with(str_in, str_obj_quotation)) {
-		str_ret = str_in.substr(0, str_in.length() - str_obj_quotation.length()) + ".rel\"";
-	} else if (string_end_with(str_in, str_lib)) {
-		str_ret = str_in.substr(0, str_in.length() - str_lib.length()) + ".lib";
-	} else if (string_end_with(str_in, str_lib_quotation)) {
-		str_ret = str_in.substr(0, str_in.length() - str_lib_quotation.length()) + ".lib\"";
-	} else if (string_end_with(str_in, str_elf)) {
-		str_ret = str_in.substr(0, str_in.length() - str_elf.length()) + ".ihx";
-	} else if (string_end_with(str_in, str_elf_quotation)) {
-		str_ret = str_in.substr(0, str_in.length() - str_elf_quotation.length()) + ".ihx\"";
-	}
-
-	return str_ret;
-}
-
-
-std::string option_filter(std::string str_in)
+    size_t i;
+    
+    keep = true;
+    
+    if (string_start_with (arg, "-mprocessor") || string_start_with (arg, "-T") || 
+        string_end_with (arg, "cpp-startup.S") || (arg == "-lm")) {
+        keep = false;
+        return arg;
+    }
+    
+    for (i = 0; i < sizeof(suffix_map) / sizeof(suffix_map[0]); ++i) {
+        if (string_end_with (arg, suffix_map[i].from)) {
+            return arg.substr (0, arg.size() - strlen (suffix_map[i].from)) + suffix_map[i].to;
+        }
+    } // End of for loop
+    
+    return arg;
+    
+} // End of option_filter()
+
+
+//----------------------------------------------------------------------------
+// opt_profile_find()
+//
+// Parameters:
+//      name : profile name from --m10-opt=
+//
+// Return Value:
+//      the profile, the legacy one if name is unknown
+//
+// Remarks:
+//      function to look up an optimization profile
+//----------------------------------------------------------------------------
+
+static const OPT_PROFILE* opt_profile_find (const std::string& name)
 {
-	std::string str_ret{ str_in };
-
-
-	if (string_start_with(str_in, "-mprocessor")) {
-		str_ret = "";
-	} else if (string_start_with(str_in, "-T")) {
-		str_ret = "";
-	} else if (string_end_with(str_in, "cpp-startup.S")) {
-		str_ret = "";
-	} else if (string_start_with(str_in, "-lm")) {
-		str_ret = "";
-	}
-	return str_ret;
-}
-
-int main(int argc, char** argv)
+    size_t i;
+    
+    for (i = 0; i < sizeof(opt_profiles) / sizeof(opt_profiles[0]); ++i) {
+        if (name == opt_profiles[i].name) {
+            return &opt_profiles[i];
+        }
+    } // End of for loop
+    
+    fprintf (stderr, "compiler_dispatch: unknown optimization profile %s, using %s\n", 
+             name.c_str(), OPT_DEFAULT);
+    
+    return opt_profile_find (OPT_DEFAULT);
+    
+} // End of opt_profile_find()
+
+
+//----------------------------------------------------------------------------
+// memory_model_find()
+//
+// Parameters:
+//      name : model name from --m10-model=
+//
+// Return Value:
+//      the memory model, large-xstack if name is unknown
+//
+// Remarks:
+//      function to look up a memory model
+//----------------------------------------------------------------------------
+
+static const MEMORY_MODEL* memory_model_find (const std::string& name)
 {
-	std::string preprocess_option { "-E" };
-	std::string build_script_option{ "-T" };
-	std::string dash_c_option{ "-c" };
-
-	//std::string current_dir{ getexepath() };
-	std::string str_argv0{argv[0]};
-
-	std::string str_path{ "." };
-	std::string str_cmd{ "" };
-	std::string str_file{ "" };
-
-	int preprocess_flag = 0;
-	int dash_c_flag = 0;
-
-	int ret;
-
-	std::string cmd_option{ "" };
-
-	for (int count = 1; count < argc; ++count) {
-		//std::cout << count << " " << argv[count] << '\n';
-		
-		if (build_script_option.compare(argv[count - 1]) == 0) {
-			continue;
-		}
-		
-		std::string str_argv_tmp{ option_filter(argv[count]) };
-
-		std::string inc_prefix{ "-I" };
-
-		std::size_t space_found = str_argv_tmp.find_last_of(" ");
-
-
-		if (space_found < MAX_PATH_LENGTH) {
-			cmd_option += " \"" + tail_replace(str_argv_tmp)  + "\"";
-		} else {
-			cmd_option += " " + tail_replace(str_argv_tmp);
-		}
-
-		
-		if (preprocess_option.compare(argv[count]) == 0) {
-			preprocess_flag = 1;
-		}
-
-		if (dash_c_option.compare(argv[count]) == 0) {
-			dash_c_flag = 1;
-		}
-
-	}
-	
-	std::size_t found = str_argv0.find_last_of("/\\");
-
-	if (found < MAX_PATH_LENGTH) {
-		str_path = str_argv0.substr(0, found);
-		str_file = str_argv0.substr(found + 1);
-	}
-	else {
-		str_file = str_argv0;
-	}
-
-
-	if (preprocess_flag) {
-		str_cmd = "\"\"" + str_path + "\\..\\..\\avr\\bin\\avr-g++.exe" + "\""  + cmd_option + "\"" ;
-	} else if (dash_c_flag) {
-		str_cmd = "\"\"" + str_path + "\\sdcc.exe" + "\""  + " --disable-warning 151 -V --model-large --iram-size 128 --stack-loc 126 --nooverlay --xstack --std-c11 --nogcse --noinduction " + cmd_option + "\"" ;
-	} else {
-		str_cmd = "\"\"" + str_path + "\\sdcc.exe" + "\"" + " --disable-warning 151 -V --model-large --iram-size 128  --stack-loc 126 --nooverlay --xstack --std-c11 --nogcse --noinduction " + cmd_option + 
-			
-			"\"" + str_path + "\\..\\core\\main.c" 
-
-			+ "\"\"";
-	}
-	 
-//	std::cout << "cmd: " << str_cmd << "\n";
-//	std::cerr << "cmd: " << str_cmd << "\n";
-
-	ret = system(str_cmd.c_str()); 
-//	ret = 0;
-	
-//	std::cerr << "ret = " << ret << "\n";
-
-//	std::cin >> c;
-
-	return ret;
-
-}
\ No newline at end of file
+    size_t i;
+    
+    for (i = 0; i < sizeof(memory_models) / sizeof(memory_models[0]); ++i) {
+        if (name == memory_models[i].name) {
+            return &memory_models[i];
+        }
+    } // End of for loop
+    
+    fprintf (stderr, "compiler_dispatch: unknown memory model %s, using %s\n", 
+             name.c_str(), MODEL_DEFAULT);
+    
+    return memory_model_find (MODEL_DEFAULT);
+    
+} // End of memory_model_find()
+
+
+//----------------------------------------------------------------------------
+// stack_location()
+//
+// Parameters:
+//      loc   : address from --m10-stack=, "" if not given
+//      model : the memory model
+//
+// Return Value:
+//      --stack-loc for the build, in decimal
+//
+// Remarks:
+//      function to pick the stack placement. An address that is not a
+//      number from 8 to 255 falls back to the one of the model, and one in
+//      the direct RAM of a small model gets a warning, as DSEG is there.
+//----------------------------------------------------------------------------
+
+static std::string stack_location (const std::string& loc, const MEMORY_MODEL* model)
+{
+    char* end;
+    long n;
+    
+    if (loc.empty()) {
+        return model->stack_loc;
+    }
+    
+    n = strtol (loc.c_str(), &end, 0);
+    
+    if ((*end) || (n < 8) || (n > 255)) {
+        fprintf (stderr, "compiler_dispatch: bad stack location %s, using %s\n", 
+                 loc.c_str(), model->stack_loc);
+        return model->stack_loc;
+    }
+    
+    if ((strcmp (model->iram_size, "256") == 0) && (n < STACK_DIRECT_RAM_END)) {
+        fprintf (stderr, "compiler_dispatch: warning, the stack at %ld shares the direct RAM with "
+                 "the variables of the %s model\n", n, model->name);
+    }
+    
+    return std::to_string (n);
+    
+} // End of stack_location()
+
+
+//----------------------------------------------------------------------------
+// is_dispatcher_option()
+//
+// Parameters:
+//      arg : one argument from the IDE
+//
+// Return Value:
+//      true if arg is meant for the dispatcher itself
+//
+// Remarks:
+//      these never go to sdcc or avr-g++
+//----------------------------------------------------------------------------
+
+static bool is_dispatcher_option (const std::string& arg)
+{
+    return ((arg == UNITY_OPTION) || (arg == OVERLAY_OPTION) || (arg == LAYOUT_OPTION) ||
+            string_start_with (arg, OPT_OPTION) || string_start_with (arg, MODEL_OPTION) ||
+            string_start_with (arg, STACK_OPTION));
+    
+} // End of is_dispatcher_option()
+
+
+//----------------------------------------------------------------------------
+// main()
+//
+// Parameters:
+//      argc, argv : avr-gcc style command line from the IDE
+//
+// Return Value:
+//      exit code of the tool that did the work
+//
+// Remarks:
+//      main function
+//----------------------------------------------------------------------------
+
+int main (int argc, char* argv[])
+{
+    std::string dir = process_self_dir (argv[0]);
+    std::vector<std::string> args;
+    std::vector<std::string> main_flags;
+    std::vector<std::string> model_args;
+    std::string sdcc = process_find_tool (dir, SDCC_TOOL);
+    std::string main_rel;
+    bool preprocess = false;
+    bool compile = false;
+    bool unity = false;
+    bool overlay = false;
+    bool layout = false;
+    std::string opt_name = OPT_DEFAULT;
+    std::string model_name = MODEL_DEFAULT;
+    std::string stack_loc;
+    const OPT_PROFILE* opt;
+    const MEMORY_MODEL* model;
+    bool keep;
+    int i;
+    size_t k;
+    
+    if ((argc == 2) && (strcmp (argv[1], "--cache-stats") == 0)) {
+        cache_print_stats ();
+        return 0;
+    } else if ((argc == 2) && (strcmp (argv[1], "--cache-prune") == 0)) {
+        cache_prune ();
+        return 0;
+    } else if ((argc == 2) && (strcmp (argv[1], "--cache-clear") == 0)) {
+        cache_clear ();
+        return 0;
+    }
+    
+    for (i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "-E") == 0) {
+            preprocess = true;
+        } else if (strcmp (argv[i], "-c") == 0) {
+            compile = true;
+        } else if (strcmp (argv[i], UNITY_OPTION) == 0) {
+            unity = true;
+        } else if (strcmp (argv[i], OVERLAY_OPTION) == 0) {
+            overlay = true;
+        } else if (strcmp (argv[i], LAYOUT_OPTION) == 0) {
+            layout = true;
+        } else if (string_start_with (argv[i], OPT_OPTION)) {
+            opt_name = argv[i] + strlen (OPT_OPTION);
+        } else if (string_start_with (argv[i], MODEL_OPTION)) {
+            model_name = argv[i] + strlen (MODEL_OPTION);
+        } else if (string_start_with (argv[i], STACK_OPTION)) {
+            stack_loc = argv[i] + strlen (STACK_OPTION);
+        }
+    } // End of for loop
+    
+    //== preprocessing, as it is
+    if (preprocess) {
+        for (i = 1; i < argc; ++i) {
+            if (!is_dispatcher_option (argv[i])) {
+                args.push_back (argv[i]);
+            }
+        } // End of for loop
+        
+        return process_run (process_find_tool (dir, AVR_GXX_TOOL), args);
+    }
+    
+    //== compile or link with sdcc
+    for (k = 0; k < sizeof(sdcc_options) / sizeof(sdcc_options[0]); ++k) {
+        args.push_back (sdcc_options[k]);
+        main_flags.push_back (sdcc_options[k]);
+    } // End of for loop
+    
+    model = memory_model_find (model_name);
+    
+    // nothing to overlay when the locals are not in internal RAM
+    overlay = overlay && model->overlay;
+    
+    for (k = 0; (k < MODEL_MAX_OPTIONS) && model->options[k]; ++k) {
+        args.push_back (model->options[k]);
+        main_flags.push_back (model->options[k]);
+    } // End of for loop
+    
+    stack_loc = stack_location (stack_loc, model);
+    
+    // stack.h paints and checks the stack from STACK_IDATA_LOCATION
+    model_args.push_back ("--iram-size");
+    model_args.push_back (model->iram_size);
+    model_args.push_back ("--stack-loc");
+    model_args.push_back (stack_loc);
+    model_args.push_back ("-DSTACK_IDATA_LOCATION=" + stack_loc);
+    
+    for (k = 0; k < model_args.size(); ++k) {
+        args.push_back (model_args[k]);
+        main_flags.push_back (model_args[k]);
+    } // End of for loop
+    
+    opt = opt_profile_find (opt_name);
+    
+    for (k = 0; (k < OPT_MAX_OPTIONS) && opt->options[k]; ++k) {
+        args.push_back (opt->options[k]);
+        main_flags.push_back (opt->options[k]);
+    } // End of for loop
+    
+    for (i = 1; i < argc; ++i) {
+        // -T takes the linker script as the next argument
+        if ((strcmp (argv[i], "-T") == 0) && ((i + 1) < argc)) {
+            ++i;
+            continue;
+        }
+        
+        std::string arg = option_filter (argv[i], keep);
+        
+        if (keep && !is_dispatcher_option (arg)) {
+            args.push_back (arg);
+            
+            if (string_start_with (arg, "-D") || string_start_with (arg, "-U") || string_start_with (arg, "-I")) {
+                main_flags.push_back (arg);
+            }
+        }
+    } // End of for loop
+    
+    if (compile) {
+        if (unity && !unity_is_core_source (args)) {
+            return unity_record (args);
+        }
+        
+        if (overlay && !unity && !unity_is_core_source (args)) {
+            for (k = 0; k < args.size(); ++k) {
+                if (args[k] == "--nooverlay") {
+                    args.erase (args.begin() + k);
+                    break;
+                }
+            } // End of for loop
+            
+            overlay_record (args);
+        }
+        
+        return cache_compile (sdcc, args);
+    }
+    
+    //== the library set of the memory model goes ahead of sdcc's own
+    args.push_back ("-L" + path_join (path_join (dir, SDCC_LIB_DIR), model->name));
+    
+    if (unity) {
+        return unity_link (sdcc, path_join (dir, CORE_MAIN_C), args);
+    }
+    
+    if (overlay) {
+        int rc = overlay_check (sdcc, args);
+        
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    
+    main_rel = cache_core_main (sdcc, path_join (dir, CORE_MAIN_C), main_flags);
+    
+    if (main_rel.size()) {
+        args.push_back (main_rel);
+    } else {
+        args.push_back (path_join (dir, CORE_MAIN_C));
+    }
+    
+    if (layout) {
+        return layout_link (sdcc, process_find_tool (dir, SDAS_TOOL), args);
+    }
+    
+    return process_run (sdcc, args);
+    
+} // End of main()
@@ -0,0 +1,468 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "file_util.h"
+#include "process.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #include <sys/utime.h>
+    #define getpid _getpid
+    #define utime _utime
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+//----------------------------------------------------------------------------
+// file_read()
+//
+// Parameters:
+//      path    : file to read
+//      content : receives the whole file
+//
+// Return Value:
+//      false if the file can not be read
+//
+// Remarks:
+//      function to read a file into memory
+//----------------------------------------------------------------------------
+
+bool file_read (const std::string& path, std::string& content)
+{
+    char buf [16384];
+    size_t n;
+    FILE* f = fopen (path.c_str(), "rb");
+    
+    content.clear();
+    
+    if (f == NULL) {
+        return false;
+    }
+    
+    while ((n = fread (buf, 1, sizeof(buf), f)) > 0) {
+        content.append (buf, n);
+    } // End of while loop
+    
+    fclose (f);
+    
+    return true;
+    
+} // End of file_read()
+
+
+//----------------------------------------------------------------------------
+// file_write()
+//
+// Parameters:
+//      path    : file to write
+//      content : new content of the file
+//
+// Return Value:
+//      false if the file can not be written
+//
+// Remarks:
+//      function to write a file from memory
+//----------------------------------------------------------------------------
+
+bool file_write (const std::string& path, const std::string& content)
+{
+    bool ok;
+    FILE* f = fopen (path.c_str(), "wb");
+    
+    if (f == NULL) {
+        return false;
+    }
+    
+    ok = (fwrite (content.data(), 1, content.size(), f) == content.size());
+    
+    return (fclose (f) == 0) && ok;
+    
+} // End of file_write()
+
+
+//----------------------------------------------------------------------------
+// file_copy()
+//
+// Parameters:
+//      from : source file
+//      to   : destination file, replaced if it exists
+//
+// Return Value:
+//      false if the copy failed
+//
+// Remarks:
+//      function to copy a file
+//----------------------------------------------------------------------------
+
+bool file_copy (const std::string& from, const std::string& to)
+{
+    std::string content;
+    
+    return file_read (from, content) && file_write (to, content);
+    
+} // End of file_copy()
+
+
+//----------------------------------------------------------------------------
+// file_append()
+//
+// Parameters:
+//      path    : file to append to, created if it does not exist
+//      content : bytes to append
+//
+// Return Value:
+//      false if the file can not be written
+//
+// Remarks:
+//      function to append to a file. Small appends are atomic, which the
+//      cache statistics rely on when several builds run at once.
+//----------------------------------------------------------------------------
+
+bool file_append (const std::string& path, const std::string& content)
+{
+    bool ok;
+    FILE* f = fopen (path.c_str(), "ab");
+    
+    if (f == NULL) {
+        return false;
+    }
+    
+    ok = (fwrite (content.data(), 1, content.size(), f) == content.size());
+    
+    return (fclose (f) == 0) && ok;
+    
+} // End of file_append()
+
+
+//----------------------------------------------------------------------------
+// file_size()
+//
+// Parameters:
+//      path : file to check
+//
+// Return Value:
+//      size of the file in bytes, -1 if it does not exist
+//
+// Remarks:
+//      function to get the size of a file
+//----------------------------------------------------------------------------
+
+int64_t file_size (const std::string& path)
+{
+    struct stat st;
+    
+    if (stat (path.c_str(), &st)) {
+        return -1;
+    }
+    
+    return (int64_t)st.st_size;
+    
+} // End of file_size()
+
+
+//----------------------------------------------------------------------------
+// file_stamp()
+//
+// Parameters:
+//      path : file to check
+//
+// Return Value:
+//      "size:mtime" of the file, "" if it does not exist
+//
+// Remarks:
+//      function to tell cheaply whether a file has changed
+//----------------------------------------------------------------------------
+
+std::string file_stamp (const std::string& path)
+{
+    struct stat st;
+    char buf [64];
+    
+    if (stat (path.c_str(), &st)) {
+        return "";
+    }
+    
+    snprintf (buf, sizeof(buf), "%lld:%lld", (long long)st.st_size, (long long)st.st_mtime);
+    
+    return buf;
+    
+} // End of file_stamp()
+
+
+//----------------------------------------------------------------------------
+// file_mtime()
+//
+// Parameters:
+//      path : file to check
+//
+// Return Value:
+//      last modification time of the file, -1 if it does not exist
+//
+// Remarks:
+//      function to order cache entries by last use
+//----------------------------------------------------------------------------
+
+int64_t file_mtime (const std::string& path)
+{
+    struct stat st;
+    
+    if (stat (path.c_str(), &st)) {
+        return -1;
+    }
+    
+    return (int64_t)st.st_mtime;
+    
+} // End of file_mtime()
+
+
+//----------------------------------------------------------------------------
+// file_touch()
+//
+// Parameters:
+//      path : existing file
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to set the modification time of a file to now
+//----------------------------------------------------------------------------
+
+void file_touch (const std::string& path)
+{
+    utime (path.c_str(), NULL);
+    
+} // End of file_touch()
+
+
+//----------------------------------------------------------------------------
+// dir_make()
+//
+// Parameters:
+//      path : directory to create, with all its parents
+//
+// Return Value:
+//      false if the directory does not exist afterwards
+//
+// Remarks:
+//      function to create a directory tree (mkdir -p)
+//----------------------------------------------------------------------------
+
+bool dir_make (const std::string& path)
+{
+    size_t pos = 0;
+    std::string part;
+    
+    while (true) {
+        pos = path.find_first_of ("/\\", pos + 1);
+        part = path.substr (0, pos);
+        
+        if (part.size() && !path_exists (part)) {
+#ifdef _WIN32
+            _mkdir (part.c_str());
+#else
+            mkdir (part.c_str(), 0777);
+#endif
+        }
+        
+        if (pos == std::string::npos) {
+            break;
+        }
+    } // End of while loop
+    
+    return path_exists (path);
+    
+} // End of dir_make()
+
+
+//----------------------------------------------------------------------------
+// dir_remove()
+//
+// Parameters:
+//      path : directory to remove, with everything in it
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to remove a directory tree (rm -rf)
+//----------------------------------------------------------------------------
+
+void dir_remove (const std::string& path)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA (path_join (path, "*").c_str(), &fd);
+    
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            std::string name = fd.cFileName;
+            
+            if ((name == ".") || (name == "..")) {
+                continue;
+            }
+            
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                dir_remove (path_join (path, name));
+            } else {
+                DeleteFileA (path_join (path, name).c_str());
+            }
+        } while (FindNextFileA (h, &fd));
+        
+        FindClose (h);
+    }
+    
+    RemoveDirectoryA (path.c_str());
+#else
+    DIR* d = opendir (path.c_str());
+    struct dirent* entry;
+    struct stat st;
+    
+    if (d != NULL) {
+        while ((entry = readdir (d)) != NULL) {
+            std::string name = entry->d_name;
+            std::string child = path_join (path, name);
+            
+            if ((name == ".") || (name == "..")) {
+                continue;
+            }
+            
+            if ((lstat (child.c_str(), &st) == 0) && S_ISDIR (st.st_mode)) {
+                dir_remove (child);
+            } else {
+                unlink (child.c_str());
+            }
+        } // End of while loop
+        
+        closedir (d);
+    }
+    
+    rmdir (path.c_str());
+#endif
+} // End of dir_remove()
+
+
+//----------------------------------------------------------------------------
+// dir_list()
+//
+// Parameters:
+//      path  : directory to list
+//      names : receives the names in it, without "." and ".."
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to list a directory, names is empty if it does not exist
+//----------------------------------------------------------------------------
+
+void dir_list (const std::string& path, std::vector<std::string>& names)
+{
+    names.clear();
+    
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA (path_join (path, "*").c_str(), &fd);
+    
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            std::string name = fd.cFileName;
+            
+            if ((name != ".") && (name != "..")) {
+                names.push_back (name);
+            }
+        } while (FindNextFileA (h, &fd));
+        
+        FindClose (h);
+    }
+#else
+    DIR* d = opendir (path.c_str());
+    struct dirent* entry;
+    
+    if (d != NULL) {
+        while ((entry = readdir (d)) != NULL) {
+            std::string name = entry->d_name;
+            
+            if ((name != ".") && (name != "..")) {
+                names.push_back (name);
+            }
+        } // End of while loop
+        
+        closedir (d);
+    }
+#endif
+} // End of dir_list()
+
+
+//----------------------------------------------------------------------------
+// file_rename()
+//
+// Parameters:
+//      from : file or directory to move
+//      to   : new name, must not exist
+//
+// Return Value:
+//      false if the rename failed (for example, because "to" exists)
+//
+// Remarks:
+//      function to publish a finished cache entry in one step
+//----------------------------------------------------------------------------
+
+bool file_rename (const std::string& from, const std::string& to)
+{
+    return (rename (from.c_str(), to.c_str()) == 0);
+    
+} // End of file_rename()
+
+
+//----------------------------------------------------------------------------
+// temp_name()
+//
+// Parameters:
+//      dir    : directory for the temporary file
+//      suffix : file name suffix
+//
+// Return Value:
+//      a name in dir that no other dispatcher process uses
+//
+// Remarks:
+//      function to name temporary files, from the process ID, the time and
+//      a counter
+//----------------------------------------------------------------------------
+
+std::string temp_name (const std::string& dir, const std::string& suffix)
+{
+    static unsigned counter = 0;
+    char buf [96];
+    
+    snprintf (buf, sizeof(buf), "tmp_%lu_%lx_%u%s", (unsigned long)getpid(), 
+              (unsigned long)time (NULL), counter++, suffix.c_str());
+    
+    return path_join (dir, buf);
+    
+} // End of temp_name()
@@ -0,0 +1,46 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef FILE_UTIL_H
+#define FILE_UTIL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//============================================================================================
+// File helpers for the cache, on top of the C runtime (and the Win32 /
+// POSIX directory calls, which the C runtime does not have)
+//============================================================================================
+
+extern bool file_read (const std::string& path, std::string& content);
+extern bool file_write (const std::string& path, const std::string& content);
+extern bool file_copy (const std::string& from, const std::string& to);
+extern bool file_append (const std::string& path, const std::string& content);
+extern int64_t file_size (const std::string& path);
+extern std::string file_stamp (const std::string& path);
+extern int64_t file_mtime (const std::string& path);
+extern void file_touch (const std::string& path);
+
+extern bool dir_make (const std::string& path);
+extern void dir_remove (const std::string& path);
+extern void dir_list (const std::string& path, std::vector<std::string>& names);
+extern bool file_rename (const std::string& from, const std::string& to);
+
+extern std::string temp_name (const std::string& dir, const std::string& suffix);
+
+#endif
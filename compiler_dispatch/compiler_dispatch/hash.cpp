@@ -0,0 +1,259 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "hash.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+//----------------------------------------------------------------------------
+// Sha256::Sha256()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      constructor, sets up the initial hash value
+//----------------------------------------------------------------------------
+
+Sha256::Sha256 ()
+{
+    state_[0] = 0x6a09e667;
+    state_[1] = 0xbb67ae85;
+    state_[2] = 0x3c6ef372;
+    state_[3] = 0xa54ff53a;
+    state_[4] = 0x510e527f;
+    state_[5] = 0x9b05688c;
+    state_[6] = 0x1f83d9ab;
+    state_[7] = 0x5be0cd19;
+    
+    length_ = 0;
+    buffer_used_ = 0;
+    
+} // End of Sha256::Sha256()
+
+
+//----------------------------------------------------------------------------
+// Sha256::transform()
+//
+// Parameters:
+//      block : 64 bytes of message
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      the SHA-256 compression function
+//----------------------------------------------------------------------------
+
+void Sha256::transform (const uint8_t* block)
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t t1, t2;
+    int i;
+    
+    for (i = 0; i < 16; ++i) {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | 
+               ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    } // End of for loop
+    
+    for (i = 16; i < 64; ++i) {
+        w[i] = (ROTR (w[i - 2], 17) ^ ROTR (w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7] + 
+               (ROTR (w[i - 15], 7) ^ ROTR (w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+    } // End of for loop
+    
+    a = state_[0];
+    b = state_[1];
+    c = state_[2];
+    d = state_[3];
+    e = state_[4];
+    f = state_[5];
+    g = state_[6];
+    h = state_[7];
+    
+    for (i = 0; i < 64; ++i) {
+        t1 = h + (ROTR (e, 6) ^ ROTR (e, 11) ^ ROTR (e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        t2 = (ROTR (a, 2) ^ ROTR (a, 13) ^ ROTR (a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    } // End of for loop
+    
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+    
+} // End of Sha256::transform()
+
+
+//----------------------------------------------------------------------------
+// Sha256::update()
+//
+// Parameters:
+//      data   : message bytes
+//      length : number of bytes
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to add message bytes to the hash
+//----------------------------------------------------------------------------
+
+void Sha256::update (const void* data, size_t length)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    size_t n;
+    
+    length_ += length;
+    
+    while (length) {
+        n = 64 - buffer_used_;
+        if (n > length) {
+            n = length;
+        }
+        
+        memcpy (buffer_ + buffer_used_, p, n);
+        buffer_used_ += n;
+        p += n;
+        length -= n;
+        
+        if (buffer_used_ == 64) {
+            transform (buffer_);
+            buffer_used_ = 0;
+        }
+    } // End of while loop
+    
+} // End of Sha256::update()
+
+void Sha256::update (const std::string& s)
+{
+    update (s.data(), s.size());
+    
+} // End of Sha256::update()
+
+void Sha256::update_field (const std::string& s)
+{
+    update (s.data(), s.size() + 1);
+    
+} // End of Sha256::update_field()
+
+
+//----------------------------------------------------------------------------
+// Sha256::hex_digest()
+//
+// Parameters:
+//      None
+//
+// Return Value:
+//      the hash as 64 hex digits
+//
+// Remarks:
+//      function to pad the message and finish the hash. The object can not
+//      be updated any more afterwards.
+//----------------------------------------------------------------------------
+
+std::string Sha256::hex_digest ()
+{
+    uint64_t bits = length_ * 8;
+    uint8_t pad = 0x80;
+    uint8_t zero = 0;
+    uint8_t size [8];
+    char hex [65];
+    int i;
+    
+    update (&pad, 1);
+    
+    while (buffer_used_ != 56) {
+        update (&zero, 1);
+    } // End of while loop
+    
+    for (i = 0; i < 8; ++i) {
+        size[i] = (uint8_t)(bits >> (56 - i * 8));
+    } // End of for loop
+    
+    update (size, 8);
+    
+    for (i = 0; i < 8; ++i) {
+        snprintf (hex + i * 8, 9, "%08x", state_[i]);
+    } // End of for loop
+    
+    return std::string (hex, 64);
+    
+} // End of Sha256::hex_digest()
+
+
+//----------------------------------------------------------------------------
+// hash_file()
+//
+// Parameters:
+//      hash : hash to add the file to
+//      path : file to read
+//
+// Return Value:
+//      false if the file can not be read
+//
+// Remarks:
+//      function to add the content of a file to a hash
+//----------------------------------------------------------------------------
+
+bool hash_file (Sha256& hash, const std::string& path)
+{
+    char buf [16384];
+    size_t n;
+    FILE* f = fopen (path.c_str(), "rb");
+    
+    if (f == NULL) {
+        return false;
+    }
+    
+    while ((n = fread (buf, 1, sizeof(buf), f)) > 0) {
+        hash.update (buf, n);
+    } // End of while loop
+    
+    fclose (f);
+    
+    return true;
+    
+} // End of hash_file()
@@ -0,0 +1,52 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stdint.h>
+#include <string>
+
+//============================================================================================
+// SHA-256, for the content addressed cache
+//============================================================================================
+
+class Sha256
+{
+    public:
+        Sha256 ();
+        
+        void update (const void* data, size_t length);
+        void update (const std::string& s);
+        
+        // a string and a separator, so "ab" + "c" and "a" + "bc" differ
+        void update_field (const std::string& s);
+        
+        std::string hex_digest ();
+        
+    private:
+        void transform (const uint8_t* block);
+        
+        uint32_t state_[8];
+        uint64_t length_;
+        uint8_t  buffer_[64];
+        size_t   buffer_used_;
+};
+
+extern bool hash_file (Sha256& hash, const std::string& path);
+
+#endif
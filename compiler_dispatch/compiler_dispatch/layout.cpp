@@ -0,0 +1,630 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "layout.h"
+#include "file_util.h"
+#include "process.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define LAYOUT_AREA     "M10P"
+
+enum {
+    TABLE_NONE,
+    TABLE_LABEL,                                        // after jmp @a+dptr
+    TABLE_ENTRIES                                       // after the table label
+};
+
+enum {
+    LINE_OTHER,
+    LINE_CALL,                                          // lcall / ljmp _x
+    LINE_LOCAL_JUMP                                     // ljmp n$
+};
+
+//----------------------------------------------------------------------------
+// ends_with()
+//
+// Parameters:
+//      s      : string to check
+//      suffix : suffix to look for
+//
+// Return Value:
+//      true if s ends with suffix
+//
+// Remarks:
+//      helper for file names
+//----------------------------------------------------------------------------
+
+static bool ends_with (const std::string& s, const char* suffix)
+{
+    size_t n = strlen (suffix);
+    
+    return ((s.size() >= n) && (s.compare (s.size() - n, n, suffix) == 0));
+    
+} // End of ends_with()
+
+
+//----------------------------------------------------------------------------
+// classify()
+//
+// Parameters:
+//      line     : assembly line
+//      area     : area the line is in, updated by .area lines
+//      in_table : where in a jump table the line is, updated
+//      target   : gets the C name called or jumped to, for LINE_CALL
+//
+// Return Value:
+//      LINE_CALL, LINE_LOCAL_JUMP or LINE_OTHER
+//
+// Remarks:
+//      function to find the far calls and jumps of CSEG that could be
+//      shortened. The ljmp lines after the label that follows jmp @a+dptr
+//      are a jump table indexed in steps of 3, and are left alone.
+//----------------------------------------------------------------------------
+
+static int classify (const std::string& line, std::string& area, int& in_table, std::string& target)
+{
+    char word [256];
+    char operand [256];
+    int n;
+    
+    n = sscanf (line.c_str(), " %255s %255s", word, operand);
+    
+    if ((n <= 0) || (word[0] == ';')) {
+        return LINE_OTHER;
+    }
+    
+    if (strcmp (word, ".area") == 0) {
+        area = (n == 2) ? operand : "";
+        in_table = TABLE_NONE;
+        return LINE_OTHER;
+    }
+    
+    if ((in_table == TABLE_LABEL) && (n == 1) && (word[strlen (word) - 1] == ':')) {
+        in_table = TABLE_ENTRIES;
+        return LINE_OTHER;
+    } else if ((in_table == TABLE_ENTRIES) && (strcmp (word, "ljmp") == 0)) {
+        return LINE_OTHER;
+    }
+    
+    in_table = TABLE_NONE;
+    
+    if ((strcmp (word, "jmp") == 0) && (n == 2) && (strcmp (operand, "@a+dptr") == 0)) {
+        in_table = TABLE_LABEL;
+        return LINE_OTHER;
+    }
+    
+    if ((area != "CSEG") || (n != 2)) {
+        return LINE_OTHER;
+    }
+    
+    if ((strcmp (word, "lcall") == 0) || (strcmp (word, "ljmp") == 0)) {
+        if (operand[0] == '_') {
+            target = operand + 1;
+            return LINE_CALL;
+        }
+        
+        if ((strcmp (word, "ljmp") == 0) && (operand[strlen (operand) - 1] == '$')) {
+            return LINE_LOCAL_JUMP;
+        }
+    }
+    
+    return LINE_OTHER;
+    
+} // End of classify()
+
+
+//----------------------------------------------------------------------------
+// layout_read_module()
+//
+// Parameters:
+//      module : base set, gets the rest
+//
+// Return Value:
+//      true if the .asm and the .rel of the module could be read
+//
+// Remarks:
+//      function to read the functions, calls and CSEG size of a module
+//----------------------------------------------------------------------------
+
+bool layout_read_module (LAYOUT_MODULE& module)
+{
+    std::string text;
+    std::string area;
+    std::string target;
+    int in_table = TABLE_NONE;
+    size_t pos = 0;
+    char name [256];
+    char value [64];
+    
+    module.size = 0;
+    module.local_jumps = 0;
+    module.group = -1;
+    
+    //== CSEG size from the .rel, in hex
+    if (!file_read (module.base + ".rel", text)) {
+        return false;
+    }
+    
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+        
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        
+        if ((sscanf (text.c_str() + pos, "A %255s size %63s", name, value) == 2) && 
+            (strcmp (name, "CSEG") == 0)) {
+            module.size = strtoul (value, 0, 16);
+        }
+        
+        pos = end + 1;
+    } // End of while loop
+    
+    //== functions and calls from the .asm
+    if (!file_read (module.base + ".asm", text)) {
+        return false;
+    }
+    
+    pos = 0;
+    
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+        int kind;
+        
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        
+        std::string line = text.substr (pos, end - pos);
+        pos = end + 1;
+        
+        kind = classify (line, area, in_table, target);
+        
+        if (kind == LINE_CALL) {
+            ++module.calls[target];
+        } else if (kind == LINE_LOCAL_JUMP) {
+            ++module.local_jumps;
+        } else if ((area == "CSEG") && (sscanf (line.c_str(), "; function %255s", name) == 1)) {
+            module.functions.insert (name);
+        } else if ((sscanf (line.c_str(), " .globl %255s", name) == 1) && (name[0] == '_')) {
+            module.globals.insert (name + 1);
+        }
+    } // End of while loop
+    
+    return true;
+    
+} // End of layout_read_module()
+
+
+//----------------------------------------------------------------------------
+// layout_read_map()
+//
+// Parameters:
+//      path     : .map written by sdld
+//      code_end : gets the end of the relocatable code
+//      fixed    : gets the [start, end) of the absolute code areas
+//
+// Return Value:
+//      true if the map could be read
+//
+// Remarks:
+//      function to read the area lines of the map, like
+//      CSEG      00000067    0000185E =        6238. bytes (REL,CON,CODE)
+//----------------------------------------------------------------------------
+
+bool layout_read_map (const std::string& path, unsigned long& code_end, 
+                      std::vector<std::pair<unsigned long, unsigned long> >& fixed)
+{
+    std::string text;
+    size_t pos = 0;
+    
+    code_end = 0;
+    fixed.clear();
+    
+    if (!file_read (path, text)) {
+        return false;
+    }
+    
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+        char name [256];
+        char attributes [64];
+        unsigned long addr, size, bytes;
+        
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        
+        std::string line = text.substr (pos, end - pos);
+        pos = end + 1;
+        
+        if ((sscanf (line.c_str(), "%255s %lx %lx = %lu. bytes (%63[^)])", 
+                     name, &addr, &size, &bytes, attributes) == 5) && 
+            strstr (attributes, "CODE") && size) {
+            if (strstr (attributes, "ABS")) {
+                fixed.push_back (std::make_pair (addr, addr + size));
+            } else if ((addr + size) > code_end) {
+                code_end = addr + size;
+            }
+        }
+    } // End of while loop
+    
+    return true;
+    
+} // End of layout_read_map()
+
+
+//----------------------------------------------------------------------------
+// layout_rewrite_module()
+//
+// Parameters:
+//      module  : the module to rewrite
+//      page    : page number of its group
+//      targets : C names reachable with acall / ajmp from its page
+//      count   : gets the number of calls and jumps shortened
+//
+// Return Value:
+//      true if <base>.page.asm was written
+//
+// Remarks:
+//      function to move the CSEG of a module into the area of its group,
+//      and to shorten its calls and jumps inside that group
+//----------------------------------------------------------------------------
+
+bool layout_rewrite_module (const LAYOUT_MODULE& module, int page, 
+                            const std::set<std::string>& targets, unsigned int& count)
+{
+    std::string text;
+    std::string out;
+    std::string area;
+    std::string target;
+    int in_table = TABLE_NONE;
+    size_t pos = 0;
+    char page_area [32];
+    
+    count = 0;
+    
+    if (!file_read (module.base + ".asm", text)) {
+        return false;
+    }
+    
+    sprintf (page_area, "%s%d", LAYOUT_AREA, page);
+    
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+        size_t p;
+        int kind;
+        
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        
+        std::string line = text.substr (pos, end - pos);
+        pos = end + 1;
+        
+        kind = classify (line, area, in_table, target);
+        
+        if ((kind == LINE_LOCAL_JUMP) || ((kind == LINE_CALL) && targets.count (target))) {
+            p = line.find_first_not_of (" \t");
+            line[p] = 'a';
+            ++count;
+        } else if ((area == "CSEG") && ((p = line.find (".area")) != std::string::npos)) {
+            p = line.find ("CSEG", p);
+            line.replace (p, 4, page_area);
+        }
+        
+        out += line + "\n";
+    } // End of while loop
+    
+    return file_write (module.base + ".page.asm", out);
+    
+} // End of layout_rewrite_module()
+
+
+//----------------------------------------------------------------------------
+// layout_link()
+//
+// Parameters:
+//      sdcc : the sdcc binary
+//      sdas : the sdas8051 binary
+//      args : sdcc link arguments
+//
+// Return Value:
+//      exit code of the link
+//
+// Remarks:
+//      function to link with the calls placed for acall / ajmp, see
+//      layout.h
+//----------------------------------------------------------------------------
+
+int layout_link (const std::string& sdcc, const std::string& sdas, 
+                 const std::vector<std::string>& args)
+{
+    std::vector<LAYOUT_MODULE> modules;
+    std::vector<std::pair<unsigned long, unsigned long> > fixed;
+    std::map<std::pair<int, int>, unsigned int> weights;
+    std::map<std::pair<int, int>, unsigned int>::iterator edge;
+    std::multimap<unsigned int, std::pair<int, int> > edges;
+    std::multimap<unsigned int, std::pair<int, int> >::reverse_iterator heavy;
+    std::map<std::string, int> owner;
+    std::map<std::string, unsigned int>::const_iterator call;
+    std::vector<unsigned long> group_size;
+    std::vector<unsigned int> group_benefit;
+    std::multimap<unsigned long, int> by_size;
+    std::multimap<unsigned long, int>::reverse_iterator big;
+    std::vector<int> page_of;
+    std::vector<std::string> link_args;
+    std::string output;
+    std::string build_dir;
+    unsigned long code_end, new_end, moved, padding, base = 0;
+    unsigned int benefit;
+    unsigned int shortened = 0;
+    unsigned int count;
+    int pages = 0;
+    int placed = 0;
+    int rc;
+    size_t i, j;
+    char option [64];
+    
+    rc = process_run (sdcc, args);
+    
+    for (i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "-o") {
+            output = args[i + 1];
+        }
+    } // End of for loop
+    
+    if ((rc != 0) || !ends_with (output, ".ihx") || 
+        !layout_read_map (output.substr (0, output.size() - 4) + ".map", code_end, fixed)) {
+        return rc;
+    }
+    
+    build_dir = output.substr (0, output.find_last_of ("/\\") + 1);
+    
+    //== modules of the build folder, with their .asm
+    for (i = 0; i < args.size(); ++i) {
+        LAYOUT_MODULE module;
+        
+        if (ends_with (args[i], ".rel") && !ends_with (args[i], ".page.rel") &&
+            (args[i].compare (0, build_dir.size(), build_dir) == 0)) {
+            module.base = args[i].substr (0, args[i].size() - 4);
+            
+            if (layout_read_module (module)) {
+                modules.push_back (module);
+            }
+        }
+    } // End of for loop
+    
+    for (i = 0; i < modules.size(); ++i) {
+        std::set<std::string>::iterator f;
+        
+        for (f = modules[i].functions.begin(); f != modules[i].functions.end(); ++f) {
+            if (modules[i].globals.count (*f)) {
+                owner[*f] = (int)i;
+            }
+        } // End of for loop
+    } // End of for loop
+    
+    //== calls between modules, and a group of one for each module that fits
+    for (i = 0; i < modules.size(); ++i) {
+        for (call = modules[i].calls.begin(); call != modules[i].calls.end(); ++call) {
+            if (!modules[i].functions.count (call->first) && owner.count (call->first)) {
+                j = owner[call->first];
+                weights[std::make_pair ((int)std::min (i, j), (int)std::max (i, j))] += call->second;
+            }
+        } // End of for loop
+        
+        if (modules[i].size && (modules[i].size < LAYOUT_PAGE)) {
+            modules[i].group = (int)i;
+        }
+        
+        group_size.push_back (modules[i].size);
+    } // End of for loop
+    
+    //== merge the groups joined by the most calls, while they fit in a page
+    //   (with room for the instruction after the last one in the page)
+    for (edge = weights.begin(); edge != weights.end(); ++edge) {
+        edges.insert (std::make_pair (edge->second, edge->first));
+    } // End of for loop
+    
+    for (heavy = edges.rbegin(); heavy != edges.rend(); ++heavy) {
+        int a = modules[heavy->second.first].group;
+        int b = modules[heavy->second.second].group;
+        
+        if ((a >= 0) && (b >= 0) && (a != b) && ((group_size[a] + group_size[b]) < LAYOUT_PAGE)) {
+            for (i = 0; i < modules.size(); ++i) {
+                if (modules[i].group == b) {
+                    modules[i].group = a;
+                }
+            } // End of for loop
+            
+            group_size[a] += group_size[b];
+        }
+    } // End of for loop
+    
+    //== calls and jumps that a group keeps inside
+    group_benefit.assign (modules.size(), 0);
+    
+    for (i = 0; i < modules.size(); ++i) {
+        if (modules[i].group >= 0) {
+            group_benefit[modules[i].group] += modules[i].local_jumps;
+            
+            for (call = modules[i].calls.begin(); call != modules[i].calls.end(); ++call) {
+                if (modules[i].functions.count (call->first) || 
+                    (owner.count (call->first) && (modules[owner[call->first]].group == modules[i].group))) {
+                    group_benefit[modules[i].group] += call->second;
+                }
+            } // End of for loop
+        }
+    } // End of for loop
+    
+    //== pages above the code that stays in CSEG, the biggest group first so
+    //   that the smallest one is last and leaves no room after it
+    page_of.assign (modules.size(), -1);
+    
+    for (i = 0; i < modules.size(); ++i) {
+        if ((modules[i].group == (int)i) && group_benefit[i]) {
+            by_size.insert (std::make_pair (group_size[i], (int)i));
+        }
+    } // End of for loop
+    
+    for (big = by_size.rbegin(); big != by_size.rend(); ++big) {
+        page_of[big->second] = pages++;
+    } // End of for loop
+    
+    //== drop a page that saves fewer bytes than the room it leaves unused
+    //   up to the next 2 KB boundary, then the last page until they all fit
+    while (pages) {
+        int drop = -1;
+        
+        moved = 0;
+        benefit = 0;
+        
+        for (i = 0; i < modules.size(); ++i) {
+            if ((modules[i].group >= 0) && (page_of[modules[i].group] >= 0)) {
+                moved += modules[i].size;
+            }
+        } // End of for loop
+        
+        base = ((code_end - moved + LAYOUT_PAGE - 1) / LAYOUT_PAGE) * LAYOUT_PAGE;
+        padding = base - (code_end - moved);
+        
+        for (i = 0; i < modules.size(); ++i) {
+            if ((modules[i].group != (int)i) || (page_of[i] < 0)) {
+                continue;
+            }
+            
+            benefit += group_benefit[i];
+            
+            if (page_of[i] == (pages - 1)) {
+                if ((base + (pages - 1) * LAYOUT_PAGE + group_size[i]) > LAYOUT_CODE_MAX) {
+                    drop = (int)i;
+                }
+            } else {
+                padding += LAYOUT_PAGE - group_size[i];
+                
+                if (group_benefit[i] < (LAYOUT_PAGE - group_size[i])) {
+                    drop = (int)i;
+                }
+            }
+        } // End of for loop
+        
+        if (drop < 0) {
+            break;
+        }
+        
+        for (i = 0; i < modules.size(); ++i) {
+            if (page_of[i] > page_of[drop]) {
+                --page_of[i];
+            }
+        } // End of for loop
+        
+        page_of[drop] = -1;
+        --pages;
+    } // End of while loop
+    
+    if (pages && (benefit <= padding)) {
+        printf ("layout: %u bytes saved against %lu bytes of padding, the normal link stands\n", 
+                benefit, padding);
+        return rc;
+    }
+    
+    if (pages == 0) {
+        printf ("layout: no group saves more than the padding of its page, the normal link stands\n");
+        return rc;
+    }
+    
+    for (i = 0; i < fixed.size(); ++i) {
+        if ((fixed[i].second > base) && (fixed[i].first < (base + pages * LAYOUT_PAGE))) {
+            printf ("layout: absolute code at 0x%04lX is in the way, the normal link stands\n", fixed[i].first);
+            return rc;
+        }
+    } // End of for loop
+    
+    //== rewrite and assemble the modules of each page
+    link_args = args;
+    
+    for (i = 0; i < modules.size(); ++i) {
+        std::set<std::string> targets;
+        std::vector<std::string> as_args;
+        
+        if ((modules[i].group < 0) || (page_of[modules[i].group] < 0)) {
+            continue;
+        }
+        
+        targets = modules[i].functions;
+        
+        for (j = 0; j < modules.size(); ++j) {
+            if ((j != i) && (modules[j].group == modules[i].group)) {
+                std::set<std::string>::iterator f;
+                
+                for (f = modules[j].functions.begin(); f != modules[j].functions.end(); ++f) {
+                    if (modules[j].globals.count (*f) && !modules[i].functions.count (*f)) {
+                        targets.insert (*f);
+                    }
+                } // End of for loop
+            }
+        } // End of for loop
+        
+        as_args.push_back ("-plosgffw");
+        as_args.push_back (modules[i].base + ".page.rel");
+        as_args.push_back (modules[i].base + ".page.asm");
+        
+        if (!layout_rewrite_module (modules[i], page_of[modules[i].group], targets, count) || (process_run (sdas, as_args) != 0)) {
+            printf ("layout: could not assemble %s.page.asm, the normal link stands\n", modules[i].base.c_str());
+            return process_run (sdcc, args);
+        }
+        
+        for (j = 0; j < link_args.size(); ++j) {
+            if (link_args[j] == (modules[i].base + ".rel")) {
+                link_args[j] = modules[i].base + ".page.rel";
+            }
+        } // End of for loop
+        
+        shortened += count;
+        ++placed;
+    } // End of for loop
+    
+    for (i = 0; i < (size_t)pages; ++i) {
+        sprintf (option, "-Wl-b%s%d=0x%04lX", LAYOUT_AREA, (int)i, base + i * LAYOUT_PAGE);
+        link_args.push_back (option);
+    } // End of for loop
+    
+    //== link again, or go back to the first link
+    if (process_run (sdcc, link_args) != 0) {
+        printf ("layout: the paged link failed, the normal link stands\n");
+        return process_run (sdcc, args);
+    }
+    
+    if (!layout_read_map (output.substr (0, output.size() - 4) + ".map", new_end, fixed) || 
+        (new_end > code_end)) {
+        printf ("layout: the paged code ends at 0x%04lX, past 0x%04lX, the normal link stands\n", 
+                new_end, code_end);
+        return process_run (sdcc, args);
+    }
+    
+    printf ("layout: %u calls and jumps shortened to acall / ajmp (%u bytes), "
+            "%d modules in %d pages from 0x%04lX, code ends at 0x%04lX (was 0x%04lX)\n",
+            shortened, shortened, placed, pages, base, new_end, code_end);
+    
+    return 0;
+    
+} // End of layout_link()
@@ -0,0 +1,79 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+//============================================================================================
+// Code layout for acall / ajmp
+//
+// acall / ajmp take 2 bytes instead of the 3 of lcall / ljmp, but only reach
+// the 2 KB page of the instruction that follows them. sdcc's --acall-ajmp
+// can only be used for a program that fits in one page, so with
+// LAYOUT_OPTION the link does this instead:
+//      - link as usual, and take the end of the code from the .map
+//      - read the .asm of the sketch and library objects (those in the
+//        build folder), and their code size from the .rel, and group the
+//        modules that call each other the most into groups of less than
+//        2 KB
+//      - keep a group only if the calls it shortens save more bytes than
+//        the room its page leaves unused up to the next 2 KB boundary
+//      - give each group its own code area (M10P<n>), placed on a 2 KB
+//        boundary above the rest of the code with -Wl-b, turn the calls and
+//        jumps that stay in the group into acall / ajmp, and assemble the
+//        result into <object>.page.rel
+//      - link again with those objects, and report how many calls and
+//        jumps were shortened
+// Jump tables (the ljmp lines after jmp @a+dptr) keep their 3 byte entries.
+// If anything fails on the way, or the code of the second link ends higher
+// than that of the first, the normal link is done again and stands.
+// Where sdld really puts the pages has not been checked against a real
+// link yet, so there is no menu entry for it. test/layout_test.cpp checks
+// the .asm / .rel / .map reading and the rewrite over the samples in
+// test/asm.
+//============================================================================================
+
+#define LAYOUT_OPTION   "--m10-layout"
+#define LAYOUT_PAGE     2048
+#define LAYOUT_CODE_MAX 32768
+
+typedef struct {
+    std::string base;                                   // object without .rel
+    unsigned long size;                                 // bytes in CSEG
+    std::set<std::string> functions;                    // defined in CSEG
+    std::set<std::string> globals;                      // .globl symbols
+    std::map<std::string, unsigned int> calls;          // lcall / ljmp _x in CSEG
+    unsigned int local_jumps;                           // ljmp n$ in CSEG
+    int group;                                          // -1 if not placed
+} LAYOUT_MODULE;
+
+// the steps of layout_link(), also used by test/layout_test.cpp
+extern bool layout_read_module (LAYOUT_MODULE& module);
+extern bool layout_read_map (const std::string& path, unsigned long& code_end, 
+                             std::vector<std::pair<unsigned long, unsigned long> >& fixed);
+extern bool layout_rewrite_module (const LAYOUT_MODULE& module, int page, 
+                                   const std::set<std::string>& targets, unsigned int& count);
+
+extern int layout_link (const std::string& sdcc, const std::string& sdas, 
+                        const std::vector<std::string>& args);
+
+#endif
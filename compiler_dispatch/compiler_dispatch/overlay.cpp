@@ -0,0 +1,341 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "overlay.h"
+#include "cache.h"
+#include "file_util.h"
+#include "process.h"
+
+#include <cstdio>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+// base_of()
+//
+// Parameters:
+//      args : sdcc arguments
+//
+// Return Value:
+//      the object after -o without .rel, "" if there is none
+//
+// Remarks:
+//      helper to find the files next to the object
+//----------------------------------------------------------------------------
+
+static std::string base_of (const std::vector<std::string>& args)
+{
+    size_t i;
+    
+    for (i = 0; i + 1 < args.size(); ++i) {
+        if ((args[i] == "-o") && (args[i + 1].size() > 4) && 
+            (args[i + 1].compare (args[i + 1].size() - 4, 4, ".rel") == 0)) {
+            return args[i + 1].substr (0, args[i + 1].size() - 4);
+        }
+    } // End of for loop
+    
+    return "";
+    
+} // End of base_of()
+
+
+//----------------------------------------------------------------------------
+// symbol_after()
+//
+// Parameters:
+//      line : assembly line
+//      pos  : where the symbol starts, at its leading '_'
+//
+// Return Value:
+//      the C name of the symbol (without the '_')
+//
+// Remarks:
+//      helper for overlay_read_asm()
+//----------------------------------------------------------------------------
+
+static std::string symbol_after (const std::string& line, size_t pos)
+{
+    size_t end = pos + 1;
+    
+    while ((end < line.size()) && (isalnum ((unsigned char)line[end]) || (line[end] == '_'))) {
+        ++end;
+    } // End of while loop
+    
+    return line.substr (pos + 1, end - pos - 1);
+    
+} // End of symbol_after()
+
+
+//----------------------------------------------------------------------------
+// overlay_read_asm()
+//
+// Parameters:
+//      path      : .asm written by sdcc
+//      module    : gets the functions and the OSEG labels
+//      functions : gets the calls of each function
+//      taken     : gets the functions whose address is taken
+//
+// Return Value:
+//      true if the file could be read
+//
+// Remarks:
+//      function to go through sdcc's assembly output. A function starts
+//      at its "; function name" banner, calls are lcall / acall (and
+//      ljmp / ajmp to another function, for tail calls), an address is
+//      taken with #_name / #(_name >> 8), or in a .dw / .db / .byte
+//      table.
+//----------------------------------------------------------------------------
+
+bool overlay_read_asm (const std::string& path, OVERLAY_MODULE& module, 
+                       std::map<std::string, OVERLAY_FUNCTION>& functions, 
+                       std::set<std::string>& taken)
+{
+    std::string text;
+    std::string area;
+    std::string current;
+    size_t pos = 0;
+    
+    if (!file_read (path, text)) {
+        return false;
+    }
+    
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+        size_t p;
+        char word [256];
+        
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        
+        std::string line = text.substr (pos, end - pos);
+        pos = end + 1;
+        
+        if (sscanf (line.c_str(), " .area %255s", word) == 1) {
+            area = word;
+        } else if (sscanf (line.c_str(), "; function %255s", word) == 1) {
+            current = word;
+            module.functions.push_back (current);
+            
+            if (functions.find (current) == functions.end()) {
+                functions[current].isr = false;
+            }
+        } else if ((area == "OSEG") && (line.size() > 2) && (line[0] == '_') && 
+                   (line.find (':') != std::string::npos)) {
+            module.overlaid.push_back (line.substr (1, line.find (':') - 1));
+        } else if ((line[0] != ';') && (sscanf (line.c_str(), " %255s", word) == 1)) {
+            if (current.size()) {
+                if (strcmp (word, "reti") == 0) {
+                    functions[current].isr = true;
+                } else if ((strcmp (word, "lcall") == 0) || (strcmp (word, "acall") == 0) ||
+                           (strcmp (word, "ljmp") == 0) || (strcmp (word, "ajmp") == 0)) {
+                    p = line.find ('_');
+                    
+                    if (p != std::string::npos) {
+                        std::string target = symbol_after (line, p);
+                        
+                        if (target != current) {
+                            functions[current].calls.insert (target);
+                        }
+                    }
+                }
+            }
+            
+            if ((strcmp (word, ".dw") == 0) || (strcmp (word, ".db") == 0) || 
+                (strcmp (word, ".byte") == 0)) {
+                // pointer tables: .dw _f  /  .byte _f, (_f >> 8)
+                for (p = line.find (word) + strlen (word); p < line.size(); ++p) {
+                    if ((line[p] == '_') && strchr (" \t,(", line[p - 1])) {
+                        taken.insert (symbol_after (line, p));
+                    }
+                } // End of for loop
+            } else {
+                // immediates: #_f  /  #(_f >> 8)
+                for (p = line.find ('#'); p != std::string::npos; p = line.find ('#', p + 1)) {
+                    size_t q = ((p + 1 < line.size()) && (line[p + 1] == '(')) ? (p + 2) : (p + 1);
+                    
+                    if ((q < line.size()) && (line[q] == '_')) {
+                        taken.insert (symbol_after (line, q));
+                    }
+                } // End of for loop
+            }
+        }
+    } // End of while loop
+    
+    return true;
+    
+} // End of overlay_read_asm()
+
+
+//----------------------------------------------------------------------------
+// overlay_record()
+//
+// Parameters:
+//      args : sdcc compile arguments
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to keep the arguments of a compile next to its object, one
+//      per line, for overlay_check() to compile it again
+//----------------------------------------------------------------------------
+
+void overlay_record (const std::vector<std::string>& args)
+{
+    std::string base = base_of (args);
+    std::string content;
+    size_t i;
+    
+    if (base.empty()) {
+        return;
+    }
+    
+    for (i = 0; i < args.size(); ++i) {
+        content += args[i] + "\n";
+    } // End of for loop
+    
+    file_write (base + OVERLAY_ARGS_SUFFIX, content);
+    
+} // End of overlay_record()
+
+
+//----------------------------------------------------------------------------
+// overlay_check()
+//
+// Parameters:
+//      sdcc : the sdcc binary
+//      args : sdcc link arguments
+//
+// Return Value:
+//      0 if every module is safe to link, otherwise the exit code of the
+//      compile that failed
+//
+// Remarks:
+//      function to find the modules whose overlaid locals an ISR can reach,
+//      and to compile them again with --nooverlay, see overlay.h
+//----------------------------------------------------------------------------
+
+int overlay_check (const std::string& sdcc, const std::vector<std::string>& args)
+{
+    std::vector<OVERLAY_MODULE> modules;
+    std::map<std::string, OVERLAY_FUNCTION> functions;
+    std::set<std::string> taken;
+    std::set<std::string> reachable;
+    std::vector<std::string> pending;
+    std::map<std::string, OVERLAY_FUNCTION>::iterator it;
+    std::set<std::string>::iterator call;
+    std::string names;
+    size_t i, j, k;
+    int fixed = 0;
+    int rc;
+    
+    for (i = 0; i < args.size(); ++i) {
+        OVERLAY_MODULE module;
+        
+        if ((args[i].size() > 4) && (args[i].compare (args[i].size() - 4, 4, ".rel") == 0)) {
+            module.base = args[i].substr (0, args[i].size() - 4);
+            
+            if (path_exists (module.base + OVERLAY_ARGS_SUFFIX) && 
+                overlay_read_asm (module.base + ".asm", module, functions, taken)) {
+                modules.push_back (module);
+            }
+        }
+    } // End of for loop
+    
+    //== everything an ISR can reach
+    for (it = functions.begin(); it != functions.end(); ++it) {
+        if (it->second.isr || taken.count (it->first)) {
+            pending.push_back (it->first);
+        }
+    } // End of for loop
+    
+    while (pending.size()) {
+        std::string name = pending.back();
+        pending.pop_back();
+        
+        if (!reachable.insert (name).second) {
+            continue;
+        }
+        
+        it = functions.find (name);
+        
+        if (it != functions.end()) {
+            for (call = it->second.calls.begin(); call != it->second.calls.end(); ++call) {
+                pending.push_back (*call);
+            } // End of for loop
+        }
+    } // End of while loop
+    
+    //== modules with overlaid locals of those, by the longest function name
+    //   the OSEG label starts with
+    for (i = 0; i < modules.size(); ++i) {
+        bool unsafe = false;
+        
+        for (j = 0; (j < modules[i].overlaid.size()) && !unsafe; ++j) {
+            const std::string& label = modules[i].overlaid[j];
+            std::string owner;
+            
+            for (k = 0; k < modules[i].functions.size(); ++k) {
+                const std::string& f = modules[i].functions[k];
+                
+                if ((label.size() > f.size()) && (label.compare (0, f.size(), f) == 0) && 
+                    (label[f.size()] == '_') && (f.size() > owner.size())) {
+                    owner = f;
+                }
+            } // End of for loop
+            
+            // a label of no known function is taken as unsafe
+            unsafe = owner.empty() || reachable.count (owner);
+        } // End of for loop
+        
+        if (unsafe) {
+            std::string content;
+            std::vector<std::string> compile_args;
+            size_t pos = 0;
+            
+            file_read (modules[i].base + OVERLAY_ARGS_SUFFIX, content);
+            
+            while (pos < content.size()) {
+                size_t end = content.find ('\n', pos);
+                
+                if (end == std::string::npos) {
+                    end = content.size();
+                }
+                
+                compile_args.push_back (content.substr (pos, end - pos));
+                pos = end + 1;
+            } // End of while loop
+            
+            compile_args.push_back ("--nooverlay");
+            
+            rc = cache_compile (sdcc, compile_args);
+            
+            if (rc != 0) {
+                return rc;
+            }
+            
+            ++fixed;
+            names += " " + modules[i].base.substr (modules[i].base.find_last_of ("/\\") + 1);
+        }
+    } // End of for loop
+    
+    printf ("overlay: %u modules, %u functions reachable from ISRs, %d modules kept without overlay%s\n",
+            (unsigned int)modules.size(), (unsigned int)reachable.size(), fixed, names.c_str());
+    
+    return 0;
+    
+} // End of overlay_check()
@@ -0,0 +1,69 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+//============================================================================================
+// Overlay analysis
+//
+// sdcc overlays the locals and parameters of non-reentrant functions that
+// call nothing else (OSEG, in internal RAM), which is not safe for a
+// function an ISR can reach while the main program is in another one that
+// shares the same bytes. So the package used to build with --nooverlay.
+//
+// With OVERLAY_OPTION, in the small model (the only one with OSEG locals),
+//      - sketch and library sources are compiled without --nooverlay, and
+//        their sdcc arguments are kept next to the object (.args)
+//      - the link reads the .asm of those objects and finds every function
+//        an ISR can reach: the roots are the functions that end in reti,
+//        and those whose address is taken (handlers for attachIsrHandler()
+//        and the like), then all they call, directly or not
+//      - a module with OSEG locals of such a function is compiled again
+//        with --nooverlay (through the cache) before the link goes on
+// The core keeps --nooverlay, its ISRs call into it directly. Calls
+// through pointers other than the ones found above are not followed.
+//============================================================================================
+
+#define OVERLAY_OPTION      "--m10-overlay"
+#define OVERLAY_ARGS_SUFFIX ".args"
+
+typedef struct {
+    std::string base;                                   // object without .rel
+    std::vector<std::string> functions;                 // functions defined
+    std::vector<std::string> overlaid;                  // labels in OSEG
+} OVERLAY_MODULE;
+
+typedef struct {
+    std::set<std::string> calls;                        // functions called
+    bool isr;                                           // ends with reti
+} OVERLAY_FUNCTION;
+
+// one module's .asm, also used by test/overlay_test.cpp
+extern bool overlay_read_asm (const std::string& path, OVERLAY_MODULE& module, 
+                              std::map<std::string, OVERLAY_FUNCTION>& functions, 
+                              std::set<std::string>& taken);
+
+extern void overlay_record (const std::vector<std::string>& args);
+extern int overlay_check (const std::string& sdcc, const std::vector<std::string>& args);
+
+#endif
@@ -0,0 +1,394 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "process.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define PATH_SEPARATOR '\\'
+    #define EXE_SUFFIX ".exe"
+#else
+    #include <spawn.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+    extern char** environ;
+
+    #define PATH_SEPARATOR '/'
+    #define EXE_SUFFIX ""
+#endif
+
+//----------------------------------------------------------------------------
+// path_join()
+//
+// Parameters:
+//      dir  : directory, may be empty
+//      name : file name or relative path, with '/' as separator
+//
+// Return Value:
+//      the joined path, with the native separator
+//
+// Remarks:
+//      function to build a path next to the dispatcher
+//----------------------------------------------------------------------------
+
+std::string path_join (const std::string& dir, const std::string& name)
+{
+    std::string path = dir;
+    size_t i;
+    
+    if (path.size() && (path[path.size() - 1] != '/') && (path[path.size() - 1] != '\\')) {
+        path += PATH_SEPARATOR;
+    }
+    
+    for (i = 0; i < name.size(); ++i) {
+        path += (name[i] == '/') ? PATH_SEPARATOR : name[i];
+    } // End of for loop
+    
+    return path;
+    
+} // End of path_join()
+
+
+//----------------------------------------------------------------------------
+// path_exists()
+//
+// Parameters:
+//      path : file to look for
+//
+// Return Value:
+//      true if the file exists
+//
+// Remarks:
+//      function to check for a file
+//----------------------------------------------------------------------------
+
+bool path_exists (const std::string& path)
+{
+#ifdef _WIN32
+    return (GetFileAttributesA (path.c_str()) != INVALID_FILE_ATTRIBUTES);
+#else
+    struct stat st;
+    
+    return (stat (path.c_str(), &st) == 0);
+#endif
+} // End of path_exists()
+
+
+//----------------------------------------------------------------------------
+// process_self_dir()
+//
+// Parameters:
+//      argv0 : argv[0] of the dispatcher
+//
+// Return Value:
+//      the directory the dispatcher lives in, "" if argv[0] has none
+//
+// Remarks:
+//      function to find the tool chain, which is installed next to the
+//      dispatcher
+//----------------------------------------------------------------------------
+
+std::string process_self_dir (const char* argv0)
+{
+    std::string self;
+    size_t pos;
+    
+#ifdef _WIN32
+    char buf [MAX_PATH];
+    
+    if (GetModuleFileNameA (NULL, buf, MAX_PATH)) {
+        self = buf;
+    } else {
+        self = argv0;
+    }
+#else
+    char buf [4096];
+    ssize_t n = readlink ("/proc/self/exe", buf, sizeof(buf) - 1);
+    
+    if (n > 0) {
+        buf[n] = 0;
+        self = buf;
+    } else {
+        self = argv0;
+    }
+#endif
+
+    pos = self.find_last_of ("/\\");
+    
+    if (pos == std::string::npos) {
+        return "";
+    }
+    
+    return self.substr (0, pos);
+    
+} // End of process_self_dir()
+
+
+//----------------------------------------------------------------------------
+// process_find_tool()
+//
+// Parameters:
+//      dir  : directory to look in first
+//      name : tool name, relative to dir, without the .exe suffix
+//
+// Return Value:
+//      the path of the tool in dir if it is there, otherwise the bare tool
+//      name, to be looked up in PATH
+//
+// Remarks:
+//      function to locate sdcc / avr-g++. The Windows package ships them
+//      next to the dispatcher, while on Linux they are usually installed
+//      system wide.
+//----------------------------------------------------------------------------
+
+std::string process_find_tool (const std::string& dir, const std::string& name)
+{
+    std::string path = path_join (dir, name) + EXE_SUFFIX;
+    size_t pos;
+    
+    if (dir.size() && path_exists (path)) {
+        return path;
+    }
+    
+    pos = name.find_last_of ("/\\");
+    
+    if (pos == std::string::npos) {
+        return name;
+    }
+    
+    return name.substr (pos + 1);
+    
+} // End of process_find_tool()
+
+
+#ifdef _WIN32
+
+//----------------------------------------------------------------------------
+// quote_argument()
+//
+// Parameters:
+//      arg : one argument
+//
+// Return Value:
+//      the argument quoted the way the C runtime of the child splits its
+//      command line (backslashes are only special in front of a quote)
+//
+// Remarks:
+//      CreateProcess() takes a single command line, so the argument
+//      vector has to be joined, but no shell is involved
+//----------------------------------------------------------------------------
+
+static std::string quote_argument (const std::string& arg)
+{
+    std::string out;
+    size_t backslashes = 0;
+    size_t i;
+    
+    if (arg.size() && (arg.find_first_of (" \t\"") == std::string::npos)) {
+        return arg;
+    }
+    
+    out = "\"";
+    
+    for (i = 0; i < arg.size(); ++i) {
+        if (arg[i] == '\\') {
+            ++backslashes;
+        } else if (arg[i] == '"') {
+            out.append (backslashes * 2 + 1, '\\');
+            out += '"';
+            backslashes = 0;
+        } else {
+            out.append (backslashes, '\\');
+            out += arg[i];
+            backslashes = 0;
+        }
+    } // End of for loop
+    
+    out.append (backslashes * 2, '\\');
+    out += '"';
+    
+    return out;
+    
+} // End of quote_argument()
+
+
+//----------------------------------------------------------------------------
+// open_inheritable()
+//
+// Parameters:
+//      path : file to write, "" for none
+//
+// Return Value:
+//      handle the child can inherit, INVALID_HANDLE_VALUE if path is ""
+//      or the file can not be created
+//
+// Remarks:
+//      function to open a file for the stdout / stderr of the child
+//----------------------------------------------------------------------------
+
+static HANDLE open_inheritable (const std::string& path)
+{
+    SECURITY_ATTRIBUTES sa;
+    
+    if (path.empty()) {
+        return INVALID_HANDLE_VALUE;
+    }
+    
+    sa.nLength = sizeof(sa);
+    sa.lpSecurityDescriptor = NULL;
+    sa.bInheritHandle = TRUE;
+    
+    return CreateFileA (path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, &sa, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    
+} // End of open_inheritable()
+
+#endif
+
+//----------------------------------------------------------------------------
+// process_run()
+//
+// Parameters:
+//      program     : path of the tool, or a bare name to look up in PATH
+//      args        : arguments, not including the program itself
+//      stdout_path : file to send the stdout of the tool to, "" to inherit
+//      stderr_path : file to send the stderr of the tool to, "" to inherit
+//
+// Return Value:
+//      the exit code of the tool, PROCESS_SPAWN_FAILED if it could not be
+//      started, 128 + signal number if it was killed
+//
+// Remarks:
+//      function to run a tool and wait for it
+//----------------------------------------------------------------------------
+
+int process_run (const std::string& program, const std::vector<std::string>& args,
+                 const std::string& stdout_path, const std::string& stderr_path)
+{
+#ifdef _WIN32
+    std::string command_line = quote_argument (program);
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    DWORD exit_code = PROCESS_SPAWN_FAILED;
+    size_t i;
+    
+    for (i = 0; i < args.size(); ++i) {
+        command_line += ' ';
+        command_line += quote_argument (args[i]);
+    } // End of for loop
+    
+    HANDLE out = open_inheritable (stdout_path);
+    HANDLE err = open_inheritable (stderr_path);
+    BOOL ok;
+    
+    memset (&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    memset (&pi, 0, sizeof(pi));
+    
+    if ((out != INVALID_HANDLE_VALUE) || (err != INVALID_HANDLE_VALUE)) {
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdInput = GetStdHandle (STD_INPUT_HANDLE);
+        si.hStdOutput = (out != INVALID_HANDLE_VALUE) ? out : GetStdHandle (STD_OUTPUT_HANDLE);
+        si.hStdError = (err != INVALID_HANDLE_VALUE) ? err : GetStdHandle (STD_ERROR_HANDLE);
+    }
+    
+    std::vector<char> buf (command_line.begin(), command_line.end());
+    buf.push_back (0);
+    
+    ok = CreateProcessA (NULL, &buf[0], NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi);
+    
+    if (out != INVALID_HANDLE_VALUE) {
+        CloseHandle (out);
+    }
+    
+    if (err != INVALID_HANDLE_VALUE) {
+        CloseHandle (err);
+    }
+    
+    if (!ok) {
+        fprintf (stderr, "compiler_dispatch: cannot run %s (error %lu)\n", program.c_str(), GetLastError());
+        return PROCESS_SPAWN_FAILED;
+    }
+    
+    WaitForSingleObject (pi.hProcess, INFINITE);
+    GetExitCodeProcess (pi.hProcess, &exit_code);
+    
+    CloseHandle (pi.hThread);
+    CloseHandle (pi.hProcess);
+    
+    return (int)exit_code;
+#else
+    std::vector<char*> argv;
+    posix_spawn_file_actions_t actions;
+    pid_t pid;
+    int status;
+    int error;
+    size_t i;
+    
+    argv.push_back ((char*)program.c_str());
+    
+    for (i = 0; i < args.size(); ++i) {
+        argv.push_back ((char*)args[i].c_str());
+    } // End of for loop
+    
+    argv.push_back (NULL);
+    
+    posix_spawn_file_actions_init (&actions);
+    
+    if (stdout_path.size()) {
+        posix_spawn_file_actions_addopen (&actions, 1, stdout_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+    
+    if (stderr_path.size()) {
+        posix_spawn_file_actions_addopen (&actions, 2, stderr_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+    
+    if (program.find ('/') == std::string::npos) {
+        error = posix_spawnp (&pid, program.c_str(), &actions, NULL, &argv[0], environ);
+    } else {
+        error = posix_spawn (&pid, program.c_str(), &actions, NULL, &argv[0], environ);
+    }
+    
+    posix_spawn_file_actions_destroy (&actions);
+    
+    if (error) {
+        fprintf (stderr, "compiler_dispatch: cannot run %s (%s)\n", program.c_str(), strerror (error));
+        return PROCESS_SPAWN_FAILED;
+    }
+    
+    while (waitpid (pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return PROCESS_SPAWN_FAILED;
+        }
+    } // End of while loop
+    
+    if (WIFEXITED (status)) {
+        return WEXITSTATUS (status);
+    } else if (WIFSIGNALED (status)) {
+        return 128 + WTERMSIG (status);
+    }
+    
+    return PROCESS_SPAWN_FAILED;
+#endif
+} // End of process_run()
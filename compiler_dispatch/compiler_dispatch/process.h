@@ -0,0 +1,45 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <string>
+#include <vector>
+
+//============================================================================================
+// Process spawning
+//
+// The tool is started directly with an argument vector, no shell in
+// between, so nothing has to be quoted for cmd.exe or sh. stdin, stdout
+// and stderr are inherited, so the output of the tool goes to the IDE
+// unchanged, unless stdout / stderr are sent to a file.
+//============================================================================================
+
+// exit code returned when the tool could not be started at all
+#define PROCESS_SPAWN_FAILED 127
+
+extern int process_run (const std::string& program, const std::vector<std::string>& args,
+                        const std::string& stdout_path = "", const std::string& stderr_path = "");
+
+extern std::string process_self_dir (const char* argv0);
+extern std::string process_find_tool (const std::string& dir, const std::string& name);
+
+extern std::string path_join (const std::string& dir, const std::string& name);
+extern bool path_exists (const std::string& path);
+
+#endif
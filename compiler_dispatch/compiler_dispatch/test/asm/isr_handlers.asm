@@ -0,0 +1,205 @@
+;--------------------------------------------------------
+; isr_handlers.c, in the layout of sdcc 3.6 mcs51 output
+; (--model-small, overlay on)
+;--------------------------------------------------------
+	.module isr_handlers
+	.optsdcc -mmcs51 --model-small
+	
+;--------------------------------------------------------
+; Public variables in this module
+;--------------------------------------------------------
+	.globl _handler_table
+	.globl _timer_isr
+	.globl _setup
+	.globl _plain
+	.globl _table_fn
+	.globl _other_fn
+	.globl _my_handler
+	.globl _helper
+	.globl _attachIsrHandler
+	.globl _tick
+	.globl _timer_hook
+;--------------------------------------------------------
+; internal ram data
+;--------------------------------------------------------
+	.area DSEG    (DATA)
+_count:
+	.ds 1
+_timer_hook::
+	.ds 2
+;--------------------------------------------------------
+; overlayable items in internal ram 
+;--------------------------------------------------------
+	.area	OSEG    (OVR,DATA)
+_helper_sloc0_1_0:
+	.ds 1
+	.area	OSEG    (OVR,DATA)
+_plain_i_1_9:
+	.ds 1
+;--------------------------------------------------------
+; code
+;--------------------------------------------------------
+	.area CSEG    (CODE)
+;------------------------------------------------------------
+;Allocation info for local variables in function 'helper'
+;------------------------------------------------------------
+;sloc0                     Allocated with name '_helper_sloc0_1_0'
+;x                         Allocated to registers r7 
+;------------------------------------------------------------
+;	isr_handlers.c:12: uint8_t helper (uint8_t x)
+;	-----------------------------------------
+;	 function helper
+;	-----------------------------------------
+_helper:
+	ar7 = 0x07
+	ar6 = 0x06
+	ar5 = 0x05
+	ar4 = 0x04
+	ar3 = 0x03
+	ar2 = 0x02
+	ar1 = 0x01
+	ar0 = 0x00
+	mov	r7,dpl
+;	isr_handlers.c:14: return (x << 1) + count;
+	mov	a,r7
+	add	a,r7
+	mov	_helper_sloc0_1_0,a
+	add	a,_count
+	mov	dpl,a
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'my_handler'
+;------------------------------------------------------------
+;i                         Allocated to registers r7 
+;------------------------------------------------------------
+;	isr_handlers.c:17: void my_handler (void)
+;	-----------------------------------------
+;	 function my_handler
+;	-----------------------------------------
+_my_handler:
+;	isr_handlers.c:21: for (i = 0; i < 4; ++i) {
+	mov	r7,#0x00
+00102$:
+	cjne	r7,#0x04,00111$
+00111$:
+	jnc	00104$
+;	isr_handlers.c:22: count += helper (i);
+	mov	dpl,r7
+	push	ar7
+	lcall	_helper
+	mov	a,dpl
+	pop	ar7
+	add	a,_count
+	mov	_count,a
+	inc	r7
+	sjmp	00102$
+00104$:
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'other_fn'
+;------------------------------------------------------------
+;	isr_handlers.c:27: void other_fn (void)
+;	-----------------------------------------
+;	 function other_fn
+;	-----------------------------------------
+_other_fn:
+;	isr_handlers.c:29: ++count;
+	inc	_count
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'table_fn'
+;------------------------------------------------------------
+;	isr_handlers.c:32: void table_fn (void)
+;	-----------------------------------------
+;	 function table_fn
+;	-----------------------------------------
+_table_fn:
+;	isr_handlers.c:34: count = 0;
+	mov	_count,#0x00
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'plain'
+;------------------------------------------------------------
+;i                         Allocated with name '_plain_i_1_9'
+;------------------------------------------------------------
+;	isr_handlers.c:37: void plain (void)
+;	-----------------------------------------
+;	 function plain
+;	-----------------------------------------
+_plain:
+;	isr_handlers.c:41: for (i = 0; i < 8; ++i) {
+	mov	_plain_i_1_9,#0x00
+00102$:
+	mov	a,#0x100 - 0x08
+	add	a,_plain_i_1_9
+	jc	00104$
+;	isr_handlers.c:42: tick ();
+	lcall	_tick
+	inc	_plain_i_1_9
+	sjmp	00102$
+00104$:
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'setup'
+;------------------------------------------------------------
+;	isr_handlers.c:46: void setup (void)
+;	-----------------------------------------
+;	 function setup
+;	-----------------------------------------
+_setup:
+;	isr_handlers.c:48: attachIsrHandler (INT0_INT_INDEX, my_handler);
+	mov	_attachIsrHandler_PARM_2,#_my_handler
+	mov	(_attachIsrHandler_PARM_2 + 1),#(_my_handler >> 8)
+	mov	dpl,#0x00
+	lcall	_attachIsrHandler
+;	isr_handlers.c:49: timer_hook = other_fn;
+	mov	_timer_hook,#_other_fn
+	mov	(_timer_hook + 1),#(_other_fn >> 8)
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'timer_isr'
+;------------------------------------------------------------
+;	isr_handlers.c:52: void timer_isr (void) __interrupt (1)
+;	-----------------------------------------
+;	 function timer_isr
+;	-----------------------------------------
+_timer_isr:
+	push	bits
+	push	acc
+	push	b
+	push	dpl
+	push	dph
+	push	(0+7)
+	push	(0+6)
+	push	(0+5)
+	push	(0+4)
+	push	(0+3)
+	push	(0+2)
+	push	(0+1)
+	push	(0+0)
+	push	psw
+	mov	psw,#0x00
+;	isr_handlers.c:54: tick ();
+	lcall	_tick
+	pop	psw
+	pop	(0+0)
+	pop	(0+1)
+	pop	(0+2)
+	pop	(0+3)
+	pop	(0+4)
+	pop	(0+5)
+	pop	(0+6)
+	pop	(0+7)
+	pop	dph
+	pop	dpl
+	pop	b
+	pop	acc
+	pop	bits
+	reti
+	.area CSEG    (CODE)
+	.area CONST   (CODE)
+_handler_table:
+	.byte _table_fn, (_table_fn >> 8)
+	.byte _other_fn, (_other_fn >> 8)
+	.area XINIT   (CODE)
+	.area CABS    (ABS,CODE)
@@ -0,0 +1,60 @@
+;--------------------------------------------------------
+; large_model.c, in the layout of sdcc 3.6 mcs51 output
+; (--model-large): parameters in XSEG, a generic pointer
+; table, and a .dw table
+;--------------------------------------------------------
+	.module large_model
+	.optsdcc -mmcs51 --model-large
+	
+	.globl _install
+	.globl _first_cmd
+	.globl _second_cmd
+	.globl _attachIsrHandler
+	.globl _attachIsrHandler_PARM_2
+;--------------------------------------------------------
+; code
+;--------------------------------------------------------
+	.area CSEG    (CODE)
+;------------------------------------------------------------
+;Allocation info for local variables in function 'first_cmd'
+;------------------------------------------------------------
+;	large_model.c:8: void first_cmd (void)
+;	-----------------------------------------
+;	 function first_cmd
+;	-----------------------------------------
+_first_cmd:
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'second_cmd'
+;------------------------------------------------------------
+;	large_model.c:12: void second_cmd (void)
+;	-----------------------------------------
+;	 function second_cmd
+;	-----------------------------------------
+_second_cmd:
+	ljmp	_first_cmd
+;------------------------------------------------------------
+;Allocation info for local variables in function 'install'
+;------------------------------------------------------------
+;	large_model.c:16: void install (void)
+;	-----------------------------------------
+;	 function install
+;	-----------------------------------------
+_install:
+;	large_model.c:18: attachIsrHandler (TIMER0_INT_INDEX, fast_path);
+	mov	dptr,#_attachIsrHandler_PARM_2
+	mov	a,#_fast_path
+	movx	@dptr,a
+	mov	a,#(_fast_path >> 8)
+	inc	dptr
+	movx	@dptr,a
+	mov	dpl,#0x01
+	ljmp	_attachIsrHandler
+	.area CSEG    (CODE)
+	.area CONST   (CODE)
+_generic_table:
+	.byte _first_cmd, (_first_cmd >> 8),#0x80
+_cmd_table:
+	.dw _second_cmd
+	.dw	_last_cmd
+	.area XINIT   (CODE)
@@ -0,0 +1,98 @@
+;--------------------------------------------------------
+; layout_paged.c, in the layout of sdcc 3.6 mcs51 output
+; (--model-large): calls and tail calls to C functions,
+; local jumps, and a switch jump table
+;--------------------------------------------------------
+	.module layout_paged
+	.optsdcc -mmcs51 --model-large
+	
+	.globl _far_away
+	.globl _dispatch
+	.globl _step
+	.globl _helper
+	.globl _counter
+;--------------------------------------------------------
+; external ram data
+;--------------------------------------------------------
+	.area XSEG    (XDATA)
+_counter::
+	.ds 1
+;--------------------------------------------------------
+; code
+;--------------------------------------------------------
+	.area CSEG    (CODE)
+;------------------------------------------------------------
+;Allocation info for local variables in function 'helper'
+;------------------------------------------------------------
+;	layout_paged.c:6: void helper (void)
+;	-----------------------------------------
+;	 function helper
+;	-----------------------------------------
+_helper:
+	ar7 = 0x07
+	ar6 = 0x06
+	ar5 = 0x05
+	ar4 = 0x04
+	ar3 = 0x03
+	ar2 = 0x02
+	ar1 = 0x01
+	ar0 = 0x00
+	mov	dptr,#_counter
+	movx	a,@dptr
+	add	a,#0x01
+	movx	@dptr,a
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'step'
+;------------------------------------------------------------
+;	layout_paged.c:11: void step (uint8_t x)
+;	-----------------------------------------
+;	 function step
+;	-----------------------------------------
+_step:
+	mov	a,dpl
+	jz	00102$
+	lcall	_far_away
+	ljmp	00104$
+00102$:
+	lcall	_helper
+	ljmp	_helper
+00104$:
+	ret
+;------------------------------------------------------------
+;Allocation info for local variables in function 'dispatch'
+;------------------------------------------------------------
+;	layout_paged.c:21: void dispatch (uint8_t cmd)
+;	-----------------------------------------
+;	 function dispatch
+;	-----------------------------------------
+_dispatch:
+	mov	r7,dpl
+	mov	a,r7
+	add	a,#0xff - 0x02
+	jnc	00110$
+	ljmp	00105$
+00110$:
+	mov	a,r7
+	add	a,r7
+	add	a,r7
+	mov	dptr,#00111$
+	jmp	@a+dptr
+00111$:
+	ljmp	00101$
+	ljmp	00102$
+	ljmp	00103$
+00101$:
+	lcall	_helper
+	ljmp	00105$
+00102$:
+	lcall	_far_away
+	ljmp	00105$
+00103$:
+	mov	dpl,#0x00
+	ljmp	_step
+00105$:
+	ret
+	.area CSEG    (CODE)
+	.area CONST   (CODE)
+	.area XINIT   (CODE)
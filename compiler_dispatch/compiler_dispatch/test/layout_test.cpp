@@ -0,0 +1,191 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// layout_test
+//
+// Runs the steps of layout_link() that do not need sdcc over the samples in
+// test/asm: the functions, calls and CSEG size of a module, the code end
+// and absolute areas of a .map, and the rewrite of the calls and jumps
+// inside a page. The rewritten .asm goes to the current directory.
+// Usage: layout_test <path of test/asm>
+//============================================================================================
+
+#include "../layout.h"
+#include "../file_util.h"
+#include "../process.h"
+
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) check ((cond), #cond, __LINE__)
+
+//----------------------------------------------------------------------------
+// check()
+//
+// Parameters:
+//      ok   : the result
+//      what : the condition, as text
+//      line : where it is
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      helper to count and print failures
+//----------------------------------------------------------------------------
+
+static void check (bool ok, const char* what, int line)
+{
+    if (!ok) {
+        fprintf (stderr, "layout_test:%d: failed: %s\n", line, what);
+        ++failures;
+    }
+    
+} // End of check()
+
+
+//----------------------------------------------------------------------------
+// count()
+//
+// Parameters:
+//      text : text to search
+//      what : string to count
+//
+// Return Value:
+//      how many times what is found in text
+//
+// Remarks:
+//      helper for the checks on the rewritten .asm
+//----------------------------------------------------------------------------
+
+static unsigned int count (const std::string& text, const char* what)
+{
+    unsigned int n = 0;
+    size_t pos = 0;
+    
+    while ((pos = text.find (what, pos)) != std::string::npos) {
+        ++n;
+        ++pos;
+    } // End of while loop
+    
+    return n;
+    
+} // End of count()
+
+
+//----------------------------------------------------------------------------
+// main()
+//
+// Parameters:
+//      argc, argv : the directory of the samples
+//
+// Return Value:
+//      0 if every check passed
+//
+// Remarks:
+//      main function
+//----------------------------------------------------------------------------
+
+int main (int argc, char* argv[])
+{
+    LAYOUT_MODULE module;
+    std::vector<std::pair<unsigned long, unsigned long> > fixed;
+    std::set<std::string> targets;
+    std::string text;
+    unsigned long code_end;
+    unsigned int shortened;
+    
+    if (argc != 2) {
+        fprintf (stderr, "usage: layout_test <asm directory>\n");
+        return 2;
+    }
+    
+    //== functions, calls and size of a module
+    module.base = path_join (argv[1], "layout_paged");
+    
+    CHECK (layout_read_module (module));
+    
+    CHECK (module.size == 0x49);
+    CHECK (module.group == -1);
+    
+    CHECK (module.functions.size() == 3);
+    CHECK (module.functions.count ("helper") == 1);
+    CHECK (module.functions.count ("step") == 1);
+    CHECK (module.functions.count ("dispatch") == 1);
+    CHECK (module.globals.count ("far_away") == 1);
+    CHECK (module.globals.count ("counter") == 1);
+    
+    // lcall and tail call ljmp alike
+    CHECK (module.calls["helper"] == 3);
+    CHECK (module.calls["far_away"] == 2);
+    CHECK (module.calls["step"] == 1);
+    
+    // ljmp n$, but not the three entries of the jump table
+    CHECK (module.local_jumps == 4);
+    
+    //== code end and absolute code areas of a .map
+    CHECK (layout_read_map (path_join (argv[1], "layout_paged.map"), code_end, fixed));
+    
+    CHECK (code_end == 0x1905);
+    CHECK (fixed.size() == 2);
+    CHECK ((fixed.size() == 2) && (fixed[0].first == 0x0000) && (fixed[0].second == 0x0033));
+    CHECK ((fixed.size() == 2) && (fixed[1].first == 0x7FF0) && (fixed[1].second == 0x8000));
+    
+    CHECK (!layout_read_map (path_join (argv[1], "missing.map"), code_end, fixed));
+    
+    //== rewrite into page 2, with far_away out of the page
+    CHECK (file_read (path_join (argv[1], "layout_paged.asm"), text));
+    CHECK (file_write ("layout_paged.asm", text));
+    
+    module.base = "layout_paged";
+    targets.insert ("helper");
+    targets.insert ("step");
+    
+    CHECK (layout_rewrite_module (module, 2, targets, shortened));
+    CHECK (shortened == 8);
+    
+    CHECK (file_read ("layout_paged.page.asm", text));
+    
+    CHECK (count (text, "\tacall\t_helper\n") == 2);
+    CHECK (count (text, "\tajmp\t_helper\n") == 1);
+    CHECK (count (text, "\tajmp\t_step\n") == 1);
+    CHECK (count (text, "\tlcall\t_far_away\n") == 2);
+    CHECK (count (text, "\tajmp\t00104$\n") == 1);
+    CHECK (count (text, "\tajmp\t00105$\n") == 3);
+    
+    // the jump table keeps its 3 byte entries
+    CHECK (count (text, "\tjmp\t@a+dptr\n00111$:\n\tljmp\t00101$\n\tljmp\t00102$\n\tljmp\t00103$\n") == 1);
+    CHECK (count (text, "\tajmp\t0010") == 4);
+    
+    // both CSEG lines move to the page area, the others stay
+    CHECK (count (text, ".area CSEG") == 0);
+    CHECK (count (text, "\t.area M10P2    (CODE)\n") == 2);
+    CHECK (count (text, "\t.area CONST   (CODE)\n") == 1);
+    CHECK (count (text, "\t.area XSEG    (XDATA)\n") == 1);
+    
+    if (failures) {
+        fprintf (stderr, "layout_test: %d checks failed\n", failures);
+        return 1;
+    }
+    
+    printf ("layout_test: all checks passed\n");
+    
+    return 0;
+    
+} // End of main()
@@ -0,0 +1,170 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+//============================================================================================
+// overlay_test
+//
+// Runs overlay_read_asm() over the .asm files in test/asm, and checks the
+// functions, calls, ISRs, OSEG labels and address-taken symbols it finds.
+// Usage: overlay_test <path of test/asm>
+//============================================================================================
+
+#include "../overlay.h"
+#include "../process.h"
+
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) check ((cond), #cond, __LINE__)
+
+//----------------------------------------------------------------------------
+// check()
+//
+// Parameters:
+//      ok   : the result
+//      what : the condition, as text
+//      line : where it is
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      helper to count and print failures
+//----------------------------------------------------------------------------
+
+static void check (bool ok, const char* what, int line)
+{
+    if (!ok) {
+        fprintf (stderr, "overlay_test:%d: failed: %s\n", line, what);
+        ++failures;
+    }
+    
+} // End of check()
+
+
+//----------------------------------------------------------------------------
+// has()
+//
+// Parameters:
+//      v    : list of names
+//      name : name to look for
+//
+// Return Value:
+//      true if name is in the list
+//
+// Remarks:
+//      helper for the checks
+//----------------------------------------------------------------------------
+
+static bool has (const std::vector<std::string>& v, const char* name)
+{
+    size_t i;
+    
+    for (i = 0; i < v.size(); ++i) {
+        if (v[i] == name) {
+            return true;
+        }
+    } // End of for loop
+    
+    return false;
+    
+} // End of has()
+
+
+//----------------------------------------------------------------------------
+// main()
+//
+// Parameters:
+//      argc, argv : the directory of the .asm samples
+//
+// Return Value:
+//      0 if every check passed
+//
+// Remarks:
+//      main function
+//----------------------------------------------------------------------------
+
+int main (int argc, char* argv[])
+{
+    OVERLAY_MODULE module;
+    std::map<std::string, OVERLAY_FUNCTION> functions;
+    std::set<std::string> taken;
+    
+    if (argc != 2) {
+        fprintf (stderr, "usage: overlay_test <asm directory>\n");
+        return 2;
+    }
+    
+    //== small model: immediates in data, a .byte table, an ISR
+    CHECK (overlay_read_asm (path_join (argv[1], "isr_handlers.asm"), module, functions, taken));
+    
+    CHECK (module.functions.size() == 7);
+    CHECK (has (module.functions, "helper"));
+    CHECK (has (module.functions, "timer_isr"));
+    
+    CHECK (module.overlaid.size() == 2);
+    CHECK (has (module.overlaid, "helper_sloc0_1_0"));
+    CHECK (has (module.overlaid, "plain_i_1_9"));
+    
+    CHECK (functions["timer_isr"].isr);
+    CHECK (!functions["my_handler"].isr);
+    CHECK (functions["timer_isr"].calls.count ("tick") == 1);
+    CHECK (functions["my_handler"].calls.count ("helper") == 1);
+    CHECK (functions["setup"].calls.count ("attachIsrHandler") == 1);
+    
+    // #_name and #(_name >> 8), with the whole name
+    CHECK (taken.count ("my_handler") == 1);
+    CHECK (taken.count ("other_fn") == 1);
+    CHECK (taken.count ("y_handler") == 0);
+    CHECK (taken.count ("ther_fn") == 0);
+    
+    // .byte _name, (_name >> 8)
+    CHECK (taken.count ("table_fn") == 1);
+    CHECK (taken.count ("able_fn") == 0);
+    
+    CHECK (taken.count ("plain") == 0);
+    CHECK (taken.count ("helper") == 0);
+    
+    //== large model: immediates through dptr, tail calls, .dw tables
+    module = OVERLAY_MODULE ();
+    functions.clear();
+    taken.clear();
+    
+    CHECK (overlay_read_asm (path_join (argv[1], "large_model.asm"), module, functions, taken));
+    
+    CHECK (module.functions.size() == 3);
+    CHECK (module.overlaid.empty());
+    
+    CHECK (taken.count ("fast_path") == 1);
+    CHECK (taken.count ("first_cmd") == 1);
+    CHECK (taken.count ("second_cmd") == 1);
+    CHECK (taken.count ("last_cmd") == 1);
+    
+    CHECK (functions["second_cmd"].calls.count ("first_cmd") == 1);
+    CHECK (functions["install"].calls.count ("attachIsrHandler") == 1);
+    
+    if (failures) {
+        fprintf (stderr, "overlay_test: %d checks failed\n", failures);
+        return 1;
+    }
+    
+    printf ("overlay_test: all checks passed\n");
+    
+    return 0;
+    
+} // End of main()
@@ -0,0 +1,672 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#include "unity.h"
+#include "file_util.h"
+#include "process.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+#define UNITY_CORE_HEADER   "Arduino.h"
+#define UNITY_SOURCE_SUFFIX ".unity.c"
+
+// asxxxx area flag for absolute areas (SFR and other fixed addresses)
+#define REL_AREA_ABS 0x08
+
+typedef struct {
+    std::string name;                   // module name, from the M line
+    std::vector<std::string> defs;      // C symbols defined in relocatable areas
+    std::vector<std::string> refs;      // C symbols referred to
+} UNITY_MODULE;
+
+typedef struct {
+    std::string path;
+    std::set<std::string> tokens;       // identifiers used
+    std::vector<std::string> statics;   // file scope statics
+    std::vector<std::string> macros;    // names #defined in the source itself
+} UNITY_SOURCE;
+
+//----------------------------------------------------------------------------
+// ends_with()
+//
+// Parameters:
+//      s      : string to check
+//      suffix : suffix to look for
+//
+// Return Value:
+//      true if s ends with suffix
+//
+// Remarks:
+//      helper for the file name checks
+//----------------------------------------------------------------------------
+
+static bool ends_with (const std::string& s, const char* suffix)
+{
+    size_t n = strlen (suffix);
+
+    return ((s.size() >= n) && (s.compare (s.size() - n, n, suffix) == 0));
+
+} // End of ends_with()
+
+
+//----------------------------------------------------------------------------
+// dir_name()
+//
+// Parameters:
+//      path : file path
+//
+// Return Value:
+//      the directory part of path, "." if there is none
+//
+// Remarks:
+//      helper to find the directory of a source
+//----------------------------------------------------------------------------
+
+static std::string dir_name (const std::string& path)
+{
+    size_t pos = path.find_last_of ("/\\");
+
+    if (pos == std::string::npos) {
+        return ".";
+    }
+
+    return path.substr (0, pos);
+
+} // End of dir_name()
+
+
+//----------------------------------------------------------------------------
+// is_ident()
+//
+// Parameters:
+//      c : character
+//
+// Return Value:
+//      true if c can be part of a C identifier
+//
+// Remarks:
+//      helper for scan_source()
+//----------------------------------------------------------------------------
+
+static bool is_ident (char c)
+{
+    return ((c == '_') || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+            ((c >= '0') && (c <= '9')));
+
+} // End of is_ident()
+
+
+//----------------------------------------------------------------------------
+// scan_source()
+//
+// Parameters:
+//      text   : C source
+//      source : gets the identifiers, file scope statics and macros of text
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to do a light scan of a source, with comments, strings and
+//      numbers skipped. A file scope static is a "static" at brace depth 0,
+//      and its name is the last identifier before the first "(" (not "(*"),
+//      "[", "=", "," or ";" at that depth.
+//----------------------------------------------------------------------------
+
+static void scan_source (const std::string& text, UNITY_SOURCE& source)
+{
+    size_t i = 0;
+    size_t n = text.size();
+    int depth = 0;
+    bool line_start = true;
+    bool directive = false;
+    bool in_static = false;
+    int define_state = 0;   // 1: after '#', 2: after "#define"
+    std::string last_ident;
+
+    while (i < n) {
+        char c = text[i];
+
+        if (c == '\n') {
+            if (!((i > 0) && (text[i - 1] == '\\'))) {
+                directive = false;
+                define_state = 0;
+            }
+            line_start = true;
+            ++i;
+        } else if ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\\')) {
+            ++i;
+        } else if ((c == '/') && ((i + 1) < n) && (text[i + 1] == '/')) {
+            while ((i < n) && (text[i] != '\n')) {
+                ++i;
+            } // End of while loop
+        } else if ((c == '/') && ((i + 1) < n) && (text[i + 1] == '*')) {
+            i += 2;
+            while (((i + 1) < n) && !((text[i] == '*') && (text[i + 1] == '/'))) {
+                ++i;
+            } // End of while loop
+            i += 2;
+        } else if ((c == '"') || (c == '\'')) {
+            ++i;
+            while ((i < n) && (text[i] != c) && (text[i] != '\n')) {
+                if (text[i] == '\\') {
+                    ++i;
+                }
+                ++i;
+            } // End of while loop
+            ++i;
+            line_start = false;
+        } else if ((c == '#') && line_start) {
+            directive = true;
+            define_state = 1;
+            line_start = false;
+            ++i;
+        } else if ((c >= '0') && (c <= '9')) {
+            while ((i < n) && (is_ident (text[i]) || (text[i] == '.'))) {
+                ++i;
+            } // End of while loop
+            line_start = false;
+        } else if (is_ident (c)) {
+            size_t start = i;
+
+            while ((i < n) && is_ident (text[i])) {
+                ++i;
+            } // End of while loop
+
+            std::string ident = text.substr (start, i - start);
+
+            if (define_state == 1) {
+                define_state = (ident == "define") ? 2 : 0;
+            } else if (define_state == 2) {
+                source.macros.push_back (ident);
+                define_state = 0;
+            } else {
+                source.tokens.insert (ident);
+            }
+
+            if (!directive) {
+                if ((ident == "static") && (depth == 0)) {
+                    in_static = true;
+                    last_ident = "";
+                } else if (in_static) {
+                    last_ident = ident;
+                }
+            }
+
+            line_start = false;
+        } else {
+            if (!directive) {
+                if (c == '{') {
+                    ++depth;
+                } else if ((c == '}') && (depth > 0)) {
+                    --depth;
+                }
+
+                if (in_static && (depth == 0) && ((c == '(') || (c == '[') || (c == '=') || (c == ',') || (c == ';'))) {
+                    size_t j = i + 1;
+
+                    while ((j < n) && ((text[j] == ' ') || (text[j] == '\t'))) {
+                        ++j;
+                    } // End of while loop
+
+                    if (!((c == '(') && (j < n) && (text[j] == '*'))) {
+                        if (last_ident.size()) {
+                            source.statics.push_back (last_ident);
+                        }
+                        in_static = false;
+                    }
+                }
+            }
+
+            line_start = false;
+            ++i;
+        }
+    } // End of while loop
+
+} // End of scan_source()
+
+
+//----------------------------------------------------------------------------
+// read_rel()
+//
+// Parameters:
+//      text   : content of a .rel file
+//      module : gets the module name and its symbols
+//
+// Return Value:
+//      true if text is a .rel file with a module name
+//
+// Remarks:
+//      function to read the symbol lines of an asxxxx object. "S _x DefN"
+//      after an "A" line is defined in that area, "S _x RefN" is referred
+//      to. Symbols before the first "A" line, and those in absolute areas,
+//      are SFRs and other fixed addresses, and do not count as defined.
+//----------------------------------------------------------------------------
+
+static bool read_rel (const std::string& text, UNITY_MODULE& module)
+{
+    size_t pos = 0;
+    bool absolute = true;
+
+    if (text.empty() || (text[0] != 'X')) {
+        return false;
+    }
+
+    while (pos < text.size()) {
+        size_t end = text.find ('\n', pos);
+
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+
+        std::string line = text.substr (pos, end - pos);
+        pos = end + 1;
+
+        char name [256];
+        char value [64];
+
+        if (sscanf (line.c_str(), "M %255s", name) == 1) {
+            module.name = name;
+        } else if (sscanf (line.c_str(), "A %255s size %63s flags %63s", name, value, value) == 3) {
+            absolute = ((strtoul (value, 0, 16) & REL_AREA_ABS) != 0);
+        } else if ((sscanf (line.c_str(), "S %255s %63s", name, value) == 2) && (name[0] == '_')) {
+            if (strncmp (value, "Ref", 3) == 0) {
+                module.refs.push_back (name + 1);
+            } else if ((strncmp (value, "Def", 3) == 0) && !absolute) {
+                module.defs.push_back (name + 1);
+            }
+        }
+    } // End of while loop
+
+    return (module.name.size() != 0);
+
+} // End of read_rel()
+
+
+//----------------------------------------------------------------------------
+// read_archive()
+//
+// Parameters:
+//      path    : library (core.a)
+//      modules : gets the .rel modules in it
+//
+// Return Value:
+//      None
+//
+// Remarks:
+//      function to go through an ar archive. The symbol index and the long
+//      name table are not .rel files, and are skipped by read_rel().
+//----------------------------------------------------------------------------
+
+static void read_archive (const std::string& path, std::vector<UNITY_MODULE>& modules)
+{
+    std::string content;
+    size_t pos = 8;
+
+    if (!file_read (path, content) || (content.compare (0, 8, "!<arch>\n") != 0)) {
+        return;
+    }
+
+    while ((pos + 60) <= content.size()) {
+        size_t size = strtoul (content.substr (pos + 48, 10).c_str(), 0, 10);
+        UNITY_MODULE module;
+
+        pos += 60;
+
+        if ((pos + size) > content.size()) {
+            break;
+        }
+
+        if (read_rel (content.substr (pos, size), module)) {
+            modules.push_back (module);
+        }
+
+        pos += size + (size & 1);
+    } // End of while loop
+
+} // End of read_archive()
+
+
+//----------------------------------------------------------------------------
+// read_manifest()
+//
+// Parameters:
+//      path   : object file from the IDE
+//      source : gets the source
+//      flags  : gets the -D / -U / -I flags appended
+//
+// Return Value:
+//      true if path is a manifest written by unity_record()
+//
+// Remarks:
+//      function to tell manifests from real objects on the link line
+//----------------------------------------------------------------------------
+
+static bool read_manifest (const std::string& path, std::string& source, std::vector<std::string>& flags)
+{
+    std::string content;
+    size_t pos;
+
+    if (!file_read (path, content) || (content.compare (0, strlen (UNITY_MAGIC), UNITY_MAGIC) != 0)) {
+        return false;
+    }
+
+    pos = content.find ('\n');
+
+    while ((pos != std::string::npos) && (pos < content.size())) {
+        size_t end = content.find ('\n', pos + 1);
+
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+
+        std::string line = content.substr (pos + 1, end - pos - 1);
+
+        if (line.compare (0, 7, "source ") == 0) {
+            source = line.substr (7);
+        } else if (line.compare (0, 5, "flag ") == 0) {
+            flags.push_back (line.substr (5));
+        }
+
+        pos = end;
+    } // End of while loop
+
+    return (source.size() != 0);
+
+} // End of read_manifest()
+
+
+//----------------------------------------------------------------------------
+// source_of()
+//
+// Parameters:
+//      args : sdcc compile arguments
+//
+// Return Value:
+//      the C / C++ source being compiled, "" if there is none
+//
+// Remarks:
+//      helper for the compile side of the unity build
+//----------------------------------------------------------------------------
+
+static std::string source_of (const std::vector<std::string>& args)
+{
+    size_t i;
+
+    for (i = 0; i < args.size(); ++i) {
+        if ((args[i] == "-o") && ((i + 1) < args.size())) {
+            ++i;
+        } else if (ends_with (args[i], ".c") || ends_with (args[i], ".cpp")) {
+            return args[i];
+        }
+    } // End of for loop
+
+    return "";
+
+} // End of source_of()
+
+
+//----------------------------------------------------------------------------
+// unity_is_core_source()
+//
+// Parameters:
+//      args : sdcc compile arguments
+//
+// Return Value:
+//      true if the source is part of the core, or is not C / C++
+//
+// Remarks:
+//      the core sources are always compiled, to keep core.a a real library
+//----------------------------------------------------------------------------
+
+bool unity_is_core_source (const std::vector<std::string>& args)
+{
+    std::string source = source_of (args);
+
+    return (source.empty() || path_exists (path_join (dir_name (source), UNITY_CORE_HEADER)));
+
+} // End of unity_is_core_source()
+
+
+//----------------------------------------------------------------------------
+// unity_record()
+//
+// Parameters:
+//      args : sdcc compile arguments
+//
+// Return Value:
+//      0 if the manifest is written, 1 otherwise
+//
+// Remarks:
+//      function to stand in for a compile in the unity build. The object
+//      file (after -o) gets the source and its flags, see unity.h
+//----------------------------------------------------------------------------
+
+int unity_record (const std::vector<std::string>& args)
+{
+    std::string object;
+    std::string source = source_of (args);
+    std::string manifest = UNITY_MAGIC "\n";
+    size_t i;
+
+    for (i = 0; i < args.size(); ++i) {
+        if ((args[i] == "-o") && ((i + 1) < args.size())) {
+            object = args[++i];
+        } else if ((args[i].compare (0, 2, "-D") == 0) || (args[i].compare (0, 2, "-U") == 0) ||
+                   (args[i].compare (0, 2, "-I") == 0)) {
+            manifest += "flag " + args[i] + "\n";
+        }
+    } // End of for loop
+
+    if (object.empty() || source.empty()) {
+        fprintf (stderr, "compiler_dispatch: no source or object for the unity build\n");
+        return 1;
+    }
+
+    manifest += "source " + source + "\n";
+
+    if (!file_write (object, manifest)) {
+        fprintf (stderr, "compiler_dispatch: can not write %s\n", object.c_str());
+        return 1;
+    }
+
+    return 0;
+
+} // End of unity_record()
+
+
+//----------------------------------------------------------------------------
+// unity_link()
+//
+// Parameters:
+//      sdcc   : the sdcc binary
+//      main_c : the core main.c
+//      args   : sdcc link arguments
+//
+// Return Value:
+//      exit code of sdcc
+//
+// Remarks:
+//      function to write the unity source for the manifests on the link
+//      line, and to compile and link it with sdcc, see unity.h
+//----------------------------------------------------------------------------
+
+int unity_link (const std::string& sdcc, const std::string& main_c,
+                const std::vector<std::string>& args)
+{
+    std::vector<std::string> link_args;
+    std::vector<std::string> flags;
+    std::vector<std::string> program;
+    std::vector<UNITY_MODULE> modules;
+    std::vector<UNITY_SOURCE> sources;
+    std::vector<bool> selected;
+    std::set<std::string> needed;
+    std::string core_dir;
+    std::string output;
+    std::string unity_c;
+    std::string text;
+    bool changed = true;
+    size_t i, j, k;
+
+    //== sort the link line out
+    for (i = 0; i < args.size(); ++i) {
+        std::string source;
+
+        if ((args[i] == "-o") && ((i + 1) < args.size())) {
+            output = args[i + 1];
+        } else if ((args[i].compare (0, 2, "-I") == 0) && core_dir.empty() &&
+                   path_exists (path_join (args[i].substr (2), UNITY_CORE_HEADER))) {
+            core_dir = args[i].substr (2);
+        } else if (ends_with (args[i], ".rel") && read_manifest (args[i], source, flags)) {
+            program.push_back (source);
+            continue;
+        } else if (ends_with (args[i], ".lib")) {
+            read_archive (args[i], modules);
+        }
+
+        link_args.push_back (args[i]);
+    } // End of for loop
+
+    program.push_back (main_c);
+
+    for (i = 0; i < program.size(); ++i) {
+        UNITY_SOURCE source;
+
+        source.path = program[i];
+
+        if (file_read (program[i], text)) {
+            scan_source (text, source);
+        }
+
+        needed.insert (source.tokens.begin(), source.tokens.end());
+        sources.push_back (source);
+    } // End of for loop
+
+    //== pick the core modules the program refers to, and what they refer to
+    selected.assign (modules.size(), false);
+
+    while (changed && core_dir.size()) {
+        changed = false;
+
+        for (i = 0; i < modules.size(); ++i) {
+            if (selected[i]) {
+                continue;
+            }
+
+            for (j = 0; j < modules[i].defs.size(); ++j) {
+                if (needed.count (modules[i].defs[j])) {
+                    break;
+                }
+            } // End of for loop
+
+            if ((j < modules[i].defs.size()) && path_exists (path_join (core_dir, modules[i].name + ".c"))) {
+                selected[i] = true;
+                changed = true;
+                needed.insert (modules[i].refs.begin(), modules[i].refs.end());
+            }
+        } // End of for loop
+    } // End of while loop
+
+    for (i = modules.size(); i > 0; --i) {
+        if (selected[i - 1]) {
+            UNITY_SOURCE source;
+
+            source.path = path_join (core_dir, modules[i - 1].name + ".c");
+
+            if (file_read (source.path, text)) {
+                scan_source (text, source);
+            }
+
+            sources.insert (sources.begin(), source);
+        }
+    } // End of for loop
+
+    //== write the unity source
+    text = "// generated by compiler_dispatch for the whole program build, see unity.h\n\n";
+
+    if (core_dir.size()) {
+        text += "#include \"" UNITY_CORE_HEADER "\"\n\n";
+    }
+
+    for (i = 0; i < sources.size(); ++i) {
+        std::vector<std::string> renamed;
+        std::string path = sources[i].path;
+
+        for (j = 0; j < sources[i].statics.size(); ++j) {
+            for (k = 0; k < sources.size(); ++k) {
+                if ((k != i) && sources[k].tokens.count (sources[i].statics[j])) {
+                    renamed.push_back (sources[i].statics[j]);
+                    break;
+                }
+            } // End of for loop
+        } // End of for loop
+
+        for (j = 0; j < path.size(); ++j) {
+            if (path[j] == '\\') {
+                path[j] = '/';
+            }
+        } // End of for loop
+
+        for (j = 0; j < renamed.size(); ++j) {
+            char suffix [16];
+
+            snprintf (suffix, sizeof(suffix), "__u%u", (unsigned int)i);
+            text += "#define " + renamed[j] + " " + renamed[j] + suffix + "\n";
+        } // End of for loop
+
+        text += "#include \"" + path + "\"\n";
+
+        for (j = 0; j < renamed.size(); ++j) {
+            text += "#undef " + renamed[j] + "\n";
+        } // End of for loop
+
+        for (j = 0; j < sources[i].macros.size(); ++j) {
+            text += "#undef " + sources[i].macros[j] + "\n";
+        } // End of for loop
+
+        text += "\n";
+    } // End of for loop
+
+    if (output.empty()) {
+        output = "a.ihx";
+    }
+
+    unity_c = (ends_with (output, ".ihx") ? output.substr (0, output.size() - 4) : output) + UNITY_SOURCE_SUFFIX;
+
+    if (!file_write (unity_c, text)) {
+        fprintf (stderr, "compiler_dispatch: can not write %s\n", unity_c.c_str());
+        return 1;
+    }
+
+    //== one sdcc run, the unity source first as it has main()
+    std::vector<std::string> sdcc_args (1, unity_c);
+    std::set<std::string> seen (link_args.begin(), link_args.end());
+
+    for (i = 0; i < flags.size(); ++i) {
+        if (seen.insert (flags[i]).second) {
+            sdcc_args.push_back (flags[i]);
+        }
+    } // End of for loop
+
+    sdcc_args.insert (sdcc_args.end(), link_args.begin(), link_args.end());
+
+    return process_run (sdcc, sdcc_args);
+
+} // End of unity_link()
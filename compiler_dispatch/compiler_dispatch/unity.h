@@ -0,0 +1,56 @@
+/*
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+*/
+
+#ifndef UNITY_H
+#define UNITY_H
+
+#include <string>
+#include <vector>
+
+//============================================================================================
+// Whole program (unity) build
+//
+// With UNITY_OPTION on the command line (the "Build" menu in boards.txt),
+//      - compiling a sketch or library source does not run sdcc. The
+//        object file gets a manifest instead: UNITY_MAGIC, then the source
+//        and its -D / -U / -I flags.
+//      - core sources (the directory with Arduino.h) are compiled as usual,
+//        so core.a stays a real library.
+//      - the link writes <output>.unity.c, which #includes every source of
+//        the manifests, the core main.c, and the core sources the program
+//        refers to, and has sdcc compile and link it in one go. So sdcc
+//        sees the whole program as one translation unit.
+// The core sources are picked by the symbols the core.a modules define and
+// refer to (from their .rel), against the identifiers in the sketch and
+// library sources. Anything missed is still linked from core.a.
+//
+// As all the sources share one scope, a file scope static whose name shows
+// up in another source is renamed (#define name name__u<n>) around its
+// file, and the macros a source #defines are #undef'd after it. A static
+// whose name clashes with something in a header of another source is not
+// caught, use the normal build for such code.
+//============================================================================================
+
+#define UNITY_OPTION  "--m10-unity"
+#define UNITY_MAGIC   "M10-UNITY 1"
+
+extern bool unity_is_core_source (const std::vector<std::string>& args);
+extern int unity_record (const std::vector<std::string>& args);
+extern int unity_link (const std::string& sdcc, const std::string& main_c,
+                       const std::vector<std::string>& args);
+
+#endif
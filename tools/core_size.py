@@ -0,0 +1,116 @@
+#! python3
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+
+###############################################################################
+# Compare the code size of sketches between two builds of the core, from
+# the sdld map files (<sketch>.map in the IDE build folder).
+#
+#   core_size.py [-v] before_dir after_dir
+#   core_size.py [-v] map_dir
+#
+# Map files are matched by name. Code size is counted the same way as
+# mustang_size.py (the sum of the CODE areas), and the limit is
+# M10.upload.maximum_size. With -v, the core modules each sketch pulled
+# out of core.a are listed as well.
+###############################################################################
+
+import sys, getopt
+import os
+import re
+
+MAXIMUM_SIZE = 32768
+
+verbose = 0
+
+def read_map (path):
+    code_size = 0
+    prev_code_match = ""
+    modules = []
+    in_libraries = 0
+    
+    with open (path) as f:
+        for line in f:
+            result = re.match (r"^\w+\s+\w+\s+\w+\s+=\s+(\d+)\.\s+bytes\s+\(REL\,CON\,CODE\)", line)
+            if (result):
+                if (prev_code_match != line):
+                    code_size += int (result.group(1))
+                prev_code_match = line
+            
+            if (line.startswith ("Libraries Linked")):
+                in_libraries = 1
+            elif (in_libraries):
+                result = re.match (r"^\S.*?\s+\[\s*(\S+)\s*\]", line)
+                if (result):
+                    modules.append (result.group(1))
+                elif (line.strip () and not line.startswith ("-")):
+                    in_libraries = 0
+    
+    return code_size, sorted (set (modules))
+
+def read_dir (path):
+    maps = {}
+    for name in sorted (os.listdir (path)):
+        if (name.endswith (".map")):
+            maps[name[:-4]] = read_map (os.path.join (path, name))
+    return maps
+
+try:
+    opts, args = getopt.getopt (sys.argv[1:], "v", [])
+except getopt.GetoptError as err:
+    print (str(err))
+    sys.exit(2)
+
+for opt, arg in opts:
+    if opt == "-v":
+        verbose = 1
+
+if (len (args) == 1):
+    after = read_dir (args[0])
+    
+    print ("%-24s %8s %6s" % ("sketch", "code", "%"))
+    print ("-" * 40)
+    for name in sorted (after):
+        (size, modules) = after[name]
+        print ("%-24s %8d %6.1f" % (name, size, 100.0 * size / MAXIMUM_SIZE))
+        if (verbose):
+            print ("    " + " ".join (modules))
+    
+elif (len (args) == 2):
+    before = read_dir (args[0])
+    after = read_dir (args[1])
+    
+    print ("%-24s %8s %8s %8s %6s" % ("sketch", "before", "after", "delta", "%"))
+    print ("-" * 58)
+    
+    total_before = 0
+    total_after = 0
+    for name in sorted (set (before) & set (after)):
+        (size_before, modules_before) = before[name]
+        (size_after, modules_after) = after[name]
+        total_before += size_before
+        total_after += size_after
+        print ("%-24s %8d %8d %8d %6.1f" % (name, size_before, size_after, size_after - size_before, \
+                                             100.0 * (size_after - size_before) / size_before if size_before else 0.0))
+        if (verbose):
+            print ("    before: " + " ".join (modules_before))
+            print ("    after : " + " ".join (modules_after))
+    
+    print ("-" * 58)
+    print ("%-24s %8d %8d %8d" % ("total", total_before, total_after, total_after - total_before))
+    
+else:
+    print ("usage: core_size.py [-v] before_dir after_dir")
+    sys.exit(2)
@@ -0,0 +1,176 @@
+#! python3
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC 
+#
+# This program is distributed under a dual license: an open source license, 
+# and a commercial license. 
+# 
+# The open source license under which this program is distributed is the 
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+
+###############################################################################
+# Turn the output of profile_dump() into a table, sorted by total time,
+# and the output of isr_profile_dump() (if any) into a table of the time
+# each interrupt vector takes.
+#
+#   profile_report.py [-n names.txt] [-f MHz] dump.txt
+#   profile_report.py [-n names.txt] [-f MHz] -P COM5 [-b 921600]
+#
+# With -P, the dump command is sent to the board and the reply is read
+# back over the serial port (needs pyserial). Otherwise the dump is read
+# from the file, or from stdin. The names file has one "id name" per line.
+###############################################################################
+
+import sys, getopt
+import re
+
+cpu_mhz = 96
+baud_rate = 921600
+com_port = ""
+names = {}
+
+PROFILE_DUMP_COMMAND = b"P"
+
+def read_dump_from_port (port, baud):
+    import serial
+    
+    lines = []
+    
+    with serial.Serial (port, baud, timeout = 2) as ser:
+        ser.reset_input_buffer ()
+        ser.write (PROFILE_DUMP_COMMAND)
+        
+        # the ISR dump, if any, follows the region dump
+        while True:
+            line = ser.readline ().decode ("ascii", "replace")
+            if (len (line) == 0):
+                break
+            lines.append (line)
+            if (line.startswith ("ISR_DUMP_END")):
+                break
+    
+    return lines
+
+def parse_dump (lines):
+    regions = []
+    for line in lines:
+        result = re.match (r"^PROFILE\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)", line)
+        if (result):
+            regions.append ([int (x, 16) for x in result.groups ()])
+    return regions
+
+ISR_VECTOR_NAMES = ["INT0", "TIMER0", "INT1_I2C", "TIMER1", "SERIAL", "ADC", "CODEC"]
+
+def parse_isr_dump (lines):
+    elapsed = 0
+    vectors = []
+    latency = []
+    for line in lines:
+        fields = line.split ()
+        if (len (fields) == 0):
+            continue
+        if (fields[0] == "ISR_ELAPSED") and (len (fields) == 2):
+            elapsed = int (fields[1], 16)
+        elif (fields[0] == "ISR") and (len (fields) > 3):
+            vectors.append ([int (x, 16) for x in fields[1:]])
+        elif (fields[0] == "ISR_LATENCY"):
+            latency = [int (x, 16) for x in fields[1:]]
+    return elapsed, vectors, latency
+
+def bucket_range (bucket):
+    if (bucket == 0):
+        return "0"
+    return "%d-%d" % (1 << (bucket - 1), (1 << bucket) - 1)
+
+def print_histogram (histogram):
+    for bucket in range (len (histogram)):
+        if (histogram[bucket]):
+            print ("    %14s cycles : %d" % (bucket_range (bucket), histogram[bucket]))
+
+def print_isr_report (lines):
+    elapsed, vectors, latency = parse_isr_dump (lines)
+    
+    if (len (vectors) == 0):
+        return
+    
+    vectors.sort (key = lambda v: v[2], reverse = True)
+    
+    print ("")
+    print ("%-10s %10s %14s %10s %10s %8s" % ("vector", "count", "total cyc", "avg cyc", "max <", "cpu %"))
+    print ("-" * 67)
+    
+    for v in vectors:
+        (index, count, total) = v[0:3]
+        histogram = v[3:]
+        top = max ([b for b in range (len (histogram)) if histogram[b]] + [0])
+        name = ISR_VECTOR_NAMES[index] if index < len (ISR_VECTOR_NAMES) else str (index)
+        print ("%-10s %10d %14d %10d %10d %8.2f" % \
+               (name, count, total, total // count, 1 << top, \
+                100.0 * total / elapsed if elapsed else 0.0))
+    
+    for v in vectors:
+        name = ISR_VECTOR_NAMES[v[0]] if v[0] < len (ISR_VECTOR_NAMES) else str (v[0])
+        print ("")
+        print ("%s duration" % name)
+        print_histogram (v[3:])
+    
+    if (sum (latency)):
+        print ("")
+        print ("TIMER0 latency")
+        print_histogram (latency)
+
+try:
+    opts, args = getopt.getopt (sys.argv[1:], "n:f:P:b:", [])
+except getopt.GetoptError as err:
+    print (str(err))
+    sys.exit(2)
+
+for opt, arg in opts:
+    if opt == "-f":
+        cpu_mhz = float (arg)
+    elif opt == "-P":
+        com_port = arg
+    elif opt == "-b":
+        baud_rate = int (arg)
+    elif opt == "-n":
+        with open (arg) as f:
+            for line in f:
+                fields = line.split (None, 1)
+                if (len (fields) == 2):
+                    names[int (fields[0], 0)] = fields[1].strip ()
+
+if (com_port):
+    lines = read_dump_from_port (com_port, baud_rate)
+elif (len (args)):
+    with open (args[0]) as f:
+        lines = f.readlines ()
+else:
+    lines = sys.stdin.readlines ()
+
+regions = parse_dump (lines)
+
+if (len (regions) == 0):
+    print ("no PROFILE lines found")
+    print_isr_report (lines)
+    sys.exit(0)
+
+regions.sort (key = lambda r: r[2], reverse = True)
+grand_total = sum (r[2] for r in regions)
+
+print ("%-20s %10s %14s %10s %10s %10s %10s %6s" % \
+       ("region", "count", "total cyc", "avg cyc", "min cyc", "max cyc", "max us", "%"))
+print ("-" * 98)
+
+for (region_id, count, total, minimum, maximum) in regions:
+    name = names.get (region_id, str (region_id))
+    print ("%-20s %10d %14d %10d %10d %10d %10.1f %6.1f" % \
+           (name, count, total, total // count, minimum, maximum, \
+            maximum / cpu_mhz, 100.0 * total / grand_total if grand_total else 0.0))
+
+print_isr_report (lines)
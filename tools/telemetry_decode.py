@@ -0,0 +1,240 @@
+#! python3
+###############################################################################
+# Copyright (c) 2016, PulseRain Technology LLC
+#
+# This program is distributed under a dual license: an open source license,
+# and a commercial license.
+#
+# The open source license under which this program is distributed is the
+# GNU Public License version 3 (GPLv3).
+#
+# And for those who want to use this program in ways that are incompatible
+# with the GPLv3, PulseRain Technology LLC offers commercial license instead.
+# Please contact PulseRain Technology LLC (www.pulserain.com) for more detail.
+#
+###############################################################################
+
+###############################################################################
+# Decode the binary telemetry sent by telemetry_send() (COBS frames with
+# CRC-16/CCITT-FALSE), and append the records to one file per field.
+#
+#   telemetry_decode.py [-t types.txt] [-o out_dir] capture.bin
+#   telemetry_decode.py [-t types.txt] [-o out_dir] -P COM5 [-b 921600] [-s seconds]
+#
+# The stream is decoded as it comes in, from the serial port with -P
+# (needs pyserial), otherwise from the file or from stdin.
+#
+# Each record type has a name, and a Python struct format for one element
+# of its payload (little endian). The types file has one
+#
+#   type_id name format field [field ...]
+#
+# per line, e.g. "0x80 imu <hhh ax ay az". Types 1 ~ 4 are predefined as
+# in telemetry.h. Every element becomes one row, and every field is
+# appended to out_dir/<name>.<field>.<dtype> as a raw little endian array
+# (numpy.fromfile (path, dtype) reads it back). out_dir/columns.txt lists
+# the files with their dtype and number of rows.
+###############################################################################
+
+import sys, getopt
+import os
+import struct
+import array
+import time
+
+out_dir = "telemetry"
+baud_rate = 921600
+com_port = ""
+seconds = 0
+
+FLUSH_ROWS = 4096
+
+# struct code : (dtype, array typecode)
+FIELD_TYPES = {"B" : ("u1", "B"), "b" : ("i1", "b"), \
+               "H" : ("u2", "H"), "h" : ("i2", "h"), \
+               "I" : ("u4", "I"), "i" : ("i4", "i"), \
+               "f" : ("f4", "f")}
+
+record_types = {0x01 : ("u16", "<H", ["value"]), \
+                0x02 : ("s16", "<h", ["value"]), \
+                0x03 : ("u32", "<I", ["value"]), \
+                0x04 : ("s32", "<i", ["value"])}
+
+def crc16 (data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for i in range (8):
+            if (crc & 0x8000):
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+def cobs_decode (frame):
+    output = bytearray ()
+    index = 0
+    while (index < len (frame)):
+        code = frame[index]
+        if (code == 0) or (index + code > len (frame)):
+            return None
+        output += frame[index + 1 : index + code]
+        index += code
+        if (index < len (frame)):
+            output.append (0)
+    return bytes (output)
+
+class Column:
+    def __init__ (self, path, dtype, typecode):
+        self.path = path
+        self.dtype = dtype
+        self.values = array.array (typecode)
+        self.rows = 0
+        open (path, "wb").close ()
+
+    def append (self, value):
+        self.values.append (value)
+        self.rows += 1
+
+    def flush (self):
+        if (len (self.values)):
+            if (sys.byteorder == "big"):
+                self.values.byteswap ()
+            with open (self.path, "ab") as f:
+                self.values.tofile (f)
+            del self.values[:]
+
+class Decoder:
+    def __init__ (self):
+        self.pending = bytearray ()
+        self.columns = {}
+        self.sequence = None
+        self.frames = 0
+        self.bad_frames = 0
+        self.lost_frames = 0
+        self.unknown_frames = 0
+        self.rows = 0
+
+    def get_columns (self, type_id):
+        if (type_id not in self.columns):
+            (name, fmt, fields) = record_types[type_id]
+            codes = [c for c in fmt if c.isalpha ()]
+            self.columns[type_id] = []
+            for (field, code) in zip (fields, codes):
+                (dtype, typecode) = FIELD_TYPES[code]
+                path = os.path.join (out_dir, "%s.%s.%s" % (name, field, dtype))
+                self.columns[type_id].append (Column (path, dtype, typecode))
+        return self.columns[type_id]
+
+    def record (self, data):
+        (type_id, sequence, payload) = (data[0], data[1], data[2:])
+
+        # one sequence counter for all record types (telemetry_sequence)
+        if (self.sequence is not None):
+            self.lost_frames += (sequence - self.sequence - 1) & 0xFF
+        self.sequence = sequence
+
+        if (type_id not in record_types):
+            self.unknown_frames += 1
+            return
+
+        fmt = record_types[type_id][1]
+        size = struct.calcsize (fmt)
+        columns = self.get_columns (type_id)
+
+        for offset in range (0, len (payload) - size + 1, size):
+            for (column, value) in zip (columns, struct.unpack_from (fmt, payload, offset)):
+                column.append (value)
+            self.rows += 1
+
+        if (len (columns[0].values) >= FLUSH_ROWS):
+            for column in columns:
+                column.flush ()
+
+    def feed (self, data):
+        self.pending += data
+        while True:
+            end = self.pending.find (b"\x00")
+            if (end < 0):
+                break
+            frame = bytes (self.pending[:end])
+            del self.pending[:end + 1]
+            if (len (frame) == 0):
+                continue
+
+            decoded = cobs_decode (frame)
+            self.frames += 1
+            if (decoded is None) or (len (decoded) < 4) or \
+               (crc16 (decoded[:-2]) != ((decoded[-2] << 8) | decoded[-1])):
+                self.bad_frames += 1
+                continue
+
+            self.record (decoded[:-2])
+
+    def close (self):
+        with open (os.path.join (out_dir, "columns.txt"), "w") as f:
+            for type_id in sorted (self.columns):
+                for column in self.columns[type_id]:
+                    column.flush ()
+                    f.write ("%s %s %d\n" % (os.path.basename (column.path), column.dtype, column.rows))
+
+        print ("frames %d, bad %d, lost %d, unknown type %d, rows %d" % \
+               (self.frames, self.bad_frames, self.lost_frames, self.unknown_frames, self.rows))
+
+def read_types (path):
+    with open (path) as f:
+        for line in f:
+            fields = line.split ()
+            if (len (fields) < 4) or fields[0].startswith ("#"):
+                continue
+            codes = [c for c in fields[2] if c.isalpha ()]
+            if (len (codes) != len (fields[3:])) or any (c not in FIELD_TYPES for c in codes):
+                print ("bad type line: %s" % line.strip ())
+                sys.exit(2)
+            record_types[int (fields[0], 0)] = (fields[1], fields[2], fields[3:])
+
+try:
+    opts, args = getopt.getopt (sys.argv[1:], "t:o:P:b:s:", [])
+except getopt.GetoptError as err:
+    print (str(err))
+    sys.exit(2)
+
+for opt, arg in opts:
+    if opt == "-t":
+        read_types (arg)
+    elif opt == "-o":
+        out_dir = arg
+    elif opt == "-P":
+        com_port = arg
+    elif opt == "-b":
+        baud_rate = int (arg)
+    elif opt == "-s":
+        seconds = float (arg)
+
+if not os.path.isdir (out_dir):
+    os.makedirs (out_dir)
+
+decoder = Decoder ()
+
+try:
+    if (com_port):
+        import serial
+
+        start = time.time ()
+        with serial.Serial (com_port, baud_rate, timeout = 0.1) as ser:
+            ser.reset_input_buffer ()
+            while (seconds == 0) or (time.time () - start < seconds):
+                decoder.feed (ser.read (max (1, ser.in_waiting)))
+    else:
+        f = open (args[0], "rb") if len (args) else sys.stdin.buffer
+        while True:
+            data = f.read (4096)
+            if (len (data) == 0):
+                break
+            decoder.feed (data)
+        if (f is not sys.stdin.buffer):
+            f.close ()
+except KeyboardInterrupt:
+    pass
+
+decoder.close ()